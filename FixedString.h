@@ -24,13 +24,23 @@
 
 #else //Testing 
 #if __cplusplus < 201703L
-#error Require C++17 for non-Arduino testing. See set_number().
+#error Require C++17 for non-Arduino testing. See append_float().
 #endif
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include <charconv> //Assumes c++17+ for Non Arduino usage/testing
+#include <string_view>
+#include <functional>
+#include <atomic>
 #endif
+#include "FixedStringKernels.h"
+#include "FixedStringView.h"
+#include "FixedStringProfile.h"
 
 #ifdef ARDUINO
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -60,28 +70,427 @@
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-//  Radix
-//  used for number to string conversion
+// Overrun policies
+// What a FixedString does when text is truncated or a number does not fit, chosen by its
+// second template parameter:
+//		FixedString<64, FixedStringOverrunCount> s;
+// The operation itself returns false either way. A policy is any type with:
+//		static void overrun(const char* data, unsigned int len);
+// where data is the text that did not fit in full.
+// Define FIXEDSTRING_OVERRUN_POLICY (before including) to change the default for all strings.
 ///////////////////////////////////////////////////////////////////////////////////////////
-enum Radix { base2 = 2, base8 = 8, base10 = 10, base16 = 16 };
+//Print a message (the original behaviour), avoid on hot paths as printf can block
+struct FixedStringOverrunPrint
+{
+	static void overrun(const char* data, unsigned int len) { printf("Fixed string overrun: '%.*s'\n", static_cast<int>(len), data); }
+};
+//Nothing at all, truncation is only seen in the return values. Also allowed at compile time.
+struct FixedStringOverrunSilent
+{
+	static FIXEDSTRING_CONSTEXPR void overrun(const char*, unsigned int) {}
+};
+//Count overruns (for all strings using this policy)
+struct FixedStringOverrunCount
+{
+	static void overrun(const char*, unsigned int) { counter()++; }
+#ifndef ARDUINO
+	static unsigned long count() { return counter().load(std::memory_order_relaxed); }
+	static void reset() { counter().store(0, std::memory_order_relaxed); }
+private:
+	static std::atomic<unsigned long>& counter() { static std::atomic<unsigned long> s_count(0); return s_count; }
+#else
+	static unsigned long count() { return counter(); }
+	static void reset() { counter() = 0; }
+private:
+	static volatile unsigned long& counter() { static volatile unsigned long s_count = 0; return s_count; }
+#endif
+};
+//Call a user function, set with FixedStringOverrunCallback::set(fn)
+typedef void (*FixedStringOverrunHandler)(const char* data, unsigned int len);
+struct FixedStringOverrunCallback
+{
+	static void overrun(const char* data, unsigned int len)
+	{
+		const FixedStringOverrunHandler fn = handler();
+		if (fn != NULL)
+			fn(data, len);
+	}
+	static void set(FixedStringOverrunHandler fn) { handler() = fn; }
+private:
+	static FixedStringOverrunHandler& handler() { static FixedStringOverrunHandler s_fn = NULL; return s_fn; }
+};
+//Treat an overrun as a bug
+struct FixedStringOverrunAbort
+{
+	static void overrun(const char*, unsigned int) { abort(); }
+};
+#ifndef FIXEDSTRING_OVERRUN_POLICY
+#define FIXEDSTRING_OVERRUN_POLICY FixedStringOverrunPrint
+#endif
+
+template<unsigned int c_storage_size = 64, typename OverrunPolicy = FIXEDSTRING_OVERRUN_POLICY>
+class FixedString;
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringFormat
+// A {} style format string for FixedString::fmt() & concat_fmt():
+//		s.fmt("{}: {} of {} ({:.1}%)", name, done, total, pct);
+// The format string is parsed and checked against the argument types when it is constructed.
+// With C++20 that is done at compile time (consteval), so a bad format is a compile error and
+// at runtime only the literal text is copied and each argument written straight into the string.
+//	{}			any argument (floats use 2 decimal places, bool is true/false)
+//	{:d} {:x} {:o} {:b}	integer in base 10, 16, 8, 2
+//	{:.N}		float with N decimal places
+//	{:W}		minimum width W, numbers are right aligned, text left aligned (e.g. {:8.2} {:4x})
+//	{{ }}		literal braces
+// Arguments: integers, float/double, bool, char, const char*, char arrays, FixedString<> & views
+///////////////////////////////////////////////////////////////////////////////////////////
+#if defined(FIXEDSTRING_HAS_CONSTEXPR) && defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define FIXEDSTRING_CONSTEVAL consteval
+#define FIXEDSTRING_HAS_CONSTEVAL 1
+#else
+#define FIXEDSTRING_CONSTEVAL
+#endif
+
+enum FixedStringArgKind { arg_int, arg_float, arg_char, arg_bool, arg_text };
+//Argument kinds - unsupported types do not compile
+template<typename T> struct FixedStringArg;
+template<> struct FixedStringArg<char> { static const FixedStringArgKind kind = arg_char; };
+template<> struct FixedStringArg<signed char> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<unsigned char> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<short> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<unsigned short> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<int> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<unsigned int> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<long> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<unsigned long> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<long long> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<unsigned long long> { static const FixedStringArgKind kind = arg_int; };
+template<> struct FixedStringArg<bool> { static const FixedStringArgKind kind = arg_bool; };
+template<> struct FixedStringArg<float> { static const FixedStringArgKind kind = arg_float; };
+template<> struct FixedStringArg<double> { static const FixedStringArgKind kind = arg_float; };
+template<> struct FixedStringArg<const char*> { static const FixedStringArgKind kind = arg_text; };
+template<> struct FixedStringArg<char*> { static const FixedStringArgKind kind = arg_text; };
+template<unsigned int N> struct FixedStringArg<char[N]> { static const FixedStringArgKind kind = arg_text; };
+template<unsigned int N, typename P> struct FixedStringArg<FixedString<N, P> > { static const FixedStringArgKind kind = arg_text; };
+template<> struct FixedStringArg<FixedStringView> { static const FixedStringArgKind kind = arg_text; };
+#ifndef ARDUINO
+template<> struct FixedStringArg<std::string_view> { static const FixedStringArgKind kind = arg_text; };
+#endif
+#ifdef ARDUINO
+template<> struct FixedStringArg<String> { static const FixedStringArgKind kind = arg_text; };
+#endif
+//Stops the format parameter taking part in template argument deduction
+template<typename T> struct FixedStringIdentity { typedef T type; };
+
+//The literal text before a field and how to write the field
+struct FixedStringField
+{
+	unsigned short text_pos;
+	unsigned short text_len;
+	bool text_escaped;	//text contains {{ or }}
+	char type;			//0, 'd', 'x', 'o' or 'b'
+	unsigned char width;
+	unsigned char prec;	//c_default_prec if not given
+	static const unsigned char c_default_prec = 0xFF;
+};
+
+template<typename... Args>
+class FixedStringFormat
+{
+	static const unsigned int c_arg_cnt = sizeof...(Args);
+	const char* m_fmt;
+	bool m_valid;
+	FixedStringField m_fields[c_arg_cnt + 1];//Last holds the trailing text only
+public:
+	FIXEDSTRING_CONSTEVAL FixedStringFormat(const char* fmt) :m_fmt(fmt), m_valid(false), m_fields()
+	{
+		m_valid = parse(fmt);
+	}
+	bool valid()const { return m_valid; }
+	const char* text()const { return m_fmt; }
+	const FixedStringField& field(unsigned int index)const { return m_fields[index]; }
+private:
+	FIXEDSTRING_CONSTEXPR bool parse(const char* fmt)
+	{
+		const FixedStringArgKind kinds[c_arg_cnt + 1] = { FixedStringArg<Args>::kind..., arg_text };
+		unsigned int pos = 0;
+		unsigned int field = 0;
+		unsigned int text_pos = 0;
+		bool escaped = false;
+		while (fmt[pos] != '\0')
+		{
+			const char c = fmt[pos];
+			if ((c == '{' && fmt[pos + 1] == '{') || (c == '}' && fmt[pos + 1] == '}'))
+			{
+				escaped = true;
+				pos += 2;
+				continue;
+			}
+			if (c == '}')
+				return error("unmatched } in format");
+			if (c != '{')
+			{
+				pos++;
+				continue;
+			}
+			if (field >= c_arg_cnt)
+				return error("more {} fields than arguments");
+			FixedStringField& f = m_fields[field];
+			set_text(f, text_pos, pos, escaped);
+			pos++;
+			if (fmt[pos] == ':')
+			{
+				pos++;
+				f.width = parse_num(fmt, pos);
+				if (fmt[pos] == '.')
+				{
+					pos++;
+					if (fmt[pos] < '0' || fmt[pos] > '9')
+						return error("missing precision");
+					f.prec = parse_num(fmt, pos);
+					if (kinds[field] != arg_float)
+						return error("precision is only allowed for floating point");
+				}
+				if (fmt[pos] == 'd' || fmt[pos] == 'x' || fmt[pos] == 'o' || fmt[pos] == 'b')
+				{
+					if (kinds[field] != arg_int)
+						return error("d/x/o/b are only allowed for integers");
+					f.type = fmt[pos++];
+				}
+			}
+			if (fmt[pos] != '}')
+				return error("bad format field");
+			pos++;
+			field++;
+			text_pos = pos;
+			escaped = false;
+		}
+		if (field != c_arg_cnt)
+			return error("fewer {} fields than arguments");
+		set_text(m_fields[c_arg_cnt], text_pos, pos, escaped);
+		return true;
+	}
+	static FIXEDSTRING_CONSTEXPR void set_text(FixedStringField& f, unsigned int start, unsigned int end, bool escaped)
+	{
+		f.text_pos = static_cast<unsigned short>(start);
+		f.text_len = static_cast<unsigned short>(end - start);
+		f.text_escaped = escaped;
+		f.type = 0;
+		f.width = 0;
+		f.prec = FixedStringField::c_default_prec;
+	}
+	static FIXEDSTRING_CONSTEXPR unsigned char parse_num(const char* fmt, unsigned int& pos)
+	{
+		unsigned int n = 0;
+		for (; fmt[pos] >= '0' && fmt[pos] <= '9'; pos++)
+			n = n * 10 + static_cast<unsigned int>(fmt[pos] - '0');
+		return static_cast<unsigned char>(n > 0xFE ? 0xFE : n);
+	}
+	static FIXEDSTRING_CONSTEXPR bool error(const char* msg)
+	{
+#ifdef FIXEDSTRING_HAS_CONSTEVAL
+		format_error(msg);//Not constexpr so a bad format string is a compile error showing msg
+#else
+		(void)msg;
+#endif
+		return false;
+	}
+	static void format_error(const char*) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringConcat
+// What operator+ returns for text (FixedStrings, views, const char* and chars): the operands
+// as (pointer, length) parts, nothing is copied while the expression is built. Writing it to a
+// FixedString (construction, =, +=, assign or concat) copies each part once straight into
+// place, the total length is known up front and there is a single truncation check:
+//		const FixedString<32> key = exchange + ':' + symbol + '.' + suffix;
+// The text is the same as adding one operand at a time: each + is limited to the capacity of
+// its right hand FixedString, or the left one if the right is not a FixedString (TString).
+// It refers to its operands so use it in the same statement - never keep one in an auto (a
+// FixedString temporary is added to straight away instead, so make() + "x" is safe to keep).
+// c_str() and the comparisons build the text on use, str() gives it as a TString:
+//		printf("%s", (a + b).c_str());	if (a + '.' + b == "x.y") ...
+///////////////////////////////////////////////////////////////////////////////////////////
+//One operand of a FixedStringConcat, a char is held as c as it has nothing to point at
+struct FixedStringConcatPart
+{
+	const char* data;
+	unsigned int len;
+	char c;
+	bool is_char;
+};
+
+template<unsigned int c_parts, typename TString>
+class FixedStringConcat
+{
+	template<unsigned int, typename> friend class FixedStringConcat;
+public:
+	using size_type = unsigned int;
+	using char_type = char;
+	using const_pointer = const char*;
+private:
+	FixedStringConcatPart m_parts[c_parts];
+	size_type m_len;
+	bool m_truncated;
+	mutable TString m_text; //c_str()
+public:
+	//data must not be NULL
+	FIXEDSTRING_CONSTEXPR FixedStringConcat(const_pointer data, size_type len) :m_len(len), m_truncated(false)
+	{
+		m_parts[0].data = data;
+		m_parts[0].len = len;
+		m_parts[0].c = 0;
+		m_parts[0].is_char = false;
+	}
+	explicit FIXEDSTRING_CONSTEXPR FixedStringConcat(char_type c) :m_len(c != 0), m_truncated(false)
+	{
+		m_parts[0].data = NULL;
+		m_parts[0].len = c != 0;
+		m_parts[0].c = c;
+		m_parts[0].is_char = true;
+	}
+	//lhs then rhs, limited to TString::capacity()
+	template<unsigned int c_lhs, typename TLhs, unsigned int c_rhs, typename TRhs>
+	FIXEDSTRING_CONSTEXPR FixedStringConcat(const FixedStringConcat<c_lhs, TLhs>& lhs, const FixedStringConcat<c_rhs, TRhs>& rhs)
+		:m_len(lhs.m_len + rhs.m_len), m_truncated(lhs.m_truncated || rhs.m_truncated)
+	{
+		static_assert(c_lhs + c_rhs == c_parts, "FixedStringConcat parts");
+		for (size_type i = 0; i < c_lhs; i++)
+			m_parts[i] = lhs.m_parts[i];
+		for (size_type i = c_lhs; i < c_parts; i++)
+			m_parts[i] = rhs.m_parts[i - c_lhs];
+		if (m_len > TString::capacity())
+			limit(TString::capacity());
+	}
+
+	FIXEDSTRING_CONSTEXPR size_type length()const { return m_len; }
+	//Text was lost to an operand's capacity on the way
+	FIXEDSTRING_CONSTEXPR bool truncated()const { return m_truncated; }
+	FIXEDSTRING_CONSTEXPR TString str()const { return TString(*this); }
+	//Valid to the end of the statement, as the expression is
+	const_pointer c_str()const { m_text = *this; return m_text.c_str(); }
+	friend FIXEDSTRING_CONSTEXPR bool operator==(const FixedStringConcat& lhs, FixedStringView rhs) { return lhs.str() == rhs; }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(const FixedStringConcat& lhs, FixedStringView rhs) { return lhs.str() != rhs; }
+	friend FIXEDSTRING_CONSTEXPR bool operator==(FixedStringView lhs, const FixedStringConcat& rhs) { return rhs.str() == lhs; }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(FixedStringView lhs, const FixedStringConcat& rhs) { return rhs.str() != lhs; }
+	friend FIXEDSTRING_CONSTEXPR bool operator<(const FixedStringConcat& lhs, FixedStringView rhs) { return lhs.str().compareTo(rhs) < 0; }
+	friend FIXEDSTRING_CONSTEXPR bool operator<(FixedStringView lhs, const FixedStringConcat& rhs) { return rhs.str().compareTo(lhs) > 0; }
+	//FixedString operands exactly, else ambiguous with converting the expression to FixedString
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator==(const FixedStringConcat& lhs, const FixedString<c_size, TPolicy>& rhs) { return lhs == rhs.view(); }
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(const FixedStringConcat& lhs, const FixedString<c_size, TPolicy>& rhs) { return lhs != rhs.view(); }
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator==(const FixedString<c_size, TPolicy>& lhs, const FixedStringConcat& rhs) { return lhs.view() == rhs; }
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(const FixedString<c_size, TPolicy>& lhs, const FixedStringConcat& rhs) { return lhs.view() != rhs; }
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator<(const FixedStringConcat& lhs, const FixedString<c_size, TPolicy>& rhs) { return lhs < rhs.view(); }
+	template<unsigned int c_size, typename TPolicy>
+	friend FIXEDSTRING_CONSTEXPR bool operator<(const FixedString<c_size, TPolicy>& lhs, const FixedStringConcat& rhs) { return lhs.view() < rhs; }
+
+	//Writes the first n chars (n <= length()), no null
+	FIXEDSTRING_CONSTEXPR void copy_to(char_type* dest, size_type n)const
+	{
+		for (size_type i = 0; i < c_parts && n > 0; i++)
+		{
+			const size_type len = m_parts[i].len < n ? m_parts[i].len : n;
+			if (m_parts[i].is_char)
+			{
+				if (len > 0)
+					*dest = m_parts[i].c;
+			}
+			else
+				FixedStringKernels::move(dest, m_parts[i].data, len);
+			dest += len;
+			n -= len;
+		}
+	}
+	//Any part within [begin, begin + len) - always true at compile time where the pointers can't be compared
+	FIXEDSTRING_CONSTEXPR bool refers_to(const_pointer begin, size_type len)const
+	{
+		if (FixedStringKernels::in_constant_evaluation())
+			return true;
+		const uintptr_t first = reinterpret_cast<uintptr_t>(begin);
+		for (size_type i = 0; i < c_parts; i++)
+		{
+			const uintptr_t p = reinterpret_cast<uintptr_t>(m_parts[i].data);
+			if (!m_parts[i].is_char && p + m_parts[i].len > first && p < first + len)
+				return true;
+		}
+		return false;
+	}
+private:
+	//Cut from the end, as adding one operand at a time would have
+	FIXEDSTRING_CONSTEXPR void limit(size_type cap)
+	{
+		size_type keep = cap;
+		for (size_type i = 0; i < c_parts; i++)
+		{
+			if (m_parts[i].len > keep)
+				m_parts[i].len = keep;
+			keep -= m_parts[i].len;
+		}
+		m_len = cap;
+		m_truncated = true;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringLength
+// The type used to cache the length, the smallest that can hold the capacity:
+//	c_storage_size <= 256: 1 byte, <= 65536: 2 bytes, else 4 bytes
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned long c_storage_size, bool c_byte = (c_storage_size <= 0x100ul), bool c_short = (c_storage_size <= 0x10000ul)>
+struct FixedStringLength { typedef uint32_t type; };
+template<unsigned long c_storage_size, bool c_short>
+struct FixedStringLength<c_storage_size, true, c_short> { typedef uint8_t type; };
+template<unsigned long c_storage_size>
+struct FixedStringLength<c_storage_size, false, true> { typedef uint16_t type; };
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringRelocatable
+// FixedStringRelocatable<T>::value is true for FixedStrings: they hold no pointers into
+// themselves and have a trivial destructor, so moving one to new memory is a copy of its bytes.
+// FixedString<N>::relocate() copies only the used bytes of each, for containers that move
+// their elements in bulk (growing, shifting, sorting):
+//		if (FixedStringRelocatable<T>::value) T::relocate(new_items, old_items, size);
+///////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+struct FixedStringRelocatable { static const bool value = false; };
+template<unsigned int c_storage_size, typename OverrunPolicy>
+struct FixedStringRelocatable<FixedString<c_storage_size, OverrunPolicy> > { static const bool value = true; };
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 // FixedString
 // A wrapper class around a stack based fixed string char my_str[c_storage_size];
-// The length of the string is cached in a byte (Thus the 256 byte limit!) to speed up operations.
+// The length of the string is cached (see FixedStringLength) to speed up operations.
 // c_storage_size:  is the total bytes used for this class
-//					it must be >=4, <= 256 and divisible by 4
+//					it must be >=4 and divisible by 4
 //					the default == 64
+//					up to 256 the length takes 1 byte, so capacity() == c_storage_size - 2
+//					above that it takes 2 (or 4) bytes, e.g. FixedString<4096>::capacity() == 4093
 // It is best used on the stack as a drop-in replacement for String to avoid dynamic memory allocation
 // for smaller strings
+// Define FIXEDSTRING_ZERO_PAD (before including) to keep every byte after the end zero. Equality
+// between same size strings is then a compare of whole 16 byte blocks with no length/tail checks.
+// Code writing directly into the buffer must then call update_len().
+// Define FIXEDSTRING_PROFILE (non-Arduino) to record the lengths and truncations of each size,
+// see FixedStringProfile.
+// OverrunPolicy: what happens when text does not fit, see FixedStringOverrunPrint
+// With C++20 construction, concat, operator+, comparison and search are constexpr and a FixedString
+// can be used as a template parameter:
+//		constexpr FixedString<32> c_content_type = FixedString<32>("Content-") + "Type";
+//		template<FixedString<16> c_name> struct Header {...};
 ///////////////////////////////////////////////////////////////////////////////////////////
-template<unsigned int c_storage_size = 64>
+template<unsigned int c_storage_size, typename OverrunPolicy>
 class FixedString final
 {
 	static const unsigned int c_min_storage = 4;
-	static const unsigned int c_max_storage = 256;
 	//Min == 4 bytes Need 1 length AND 1 for zero byte so 2 char string is smallest allowed!
-	static_assert(c_storage_size >= c_min_storage && c_storage_size <= c_max_storage, "Must be between between 4 & 256");
+	static_assert(c_storage_size >= c_min_storage, "Must be at least 4");
 	static_assert(c_storage_size % 4 == 0, "Must be divisible by 4");//Force 4 byte boundary 
 public:
 	using char_type = char;
@@ -93,16 +502,28 @@ public:
 	using FlashPtr = const __FlashStringHelper*;
 #endif
 	static constexpr const size_type npos = (size_type)-1;
-	//Need 2 non-data chars: 1 for length AND 1 for zero end char
-	static constexpr const size_type capacity() { return c_storage_size - 2; }
+	using length_type = typename FixedStringLength<c_storage_size>::type;
+	//Need non-data chars for the length AND 1 for the zero end char
+	static constexpr const size_type capacity() { return c_storage_size - sizeof(length_type) - 1; }
 private:
 	//Helpers
 	static constexpr const size_type get_min(size_type i1, size_type i2) { return i1 < i2 ? i1 : i2; }
 	static constexpr const size_type get_max(size_type i1, size_type i2) { return i1 > i2 ? i1 : i2; }
 	static constexpr bool valid_len(size_type len) { return len <= capacity(); }
-	static constexpr const size_type safe_len(const_pointer str)
+	//Only use the SIMD search kernels if the string can fill a block
+	static constexpr bool c_simd = capacity() >= 16;
+	//Copied whole, up to this size it is no slower than copying the used bytes
+	static constexpr unsigned int c_copy_whole = 64;
+	//The storage always has 16 readable bytes
+	static constexpr bool c_block16 = c_storage_size - sizeof(length_type) >= 16;
+#ifdef FIXEDSTRING_ZERO_PAD
+	static constexpr bool c_zero_pad = true;
+#else
+	static constexpr bool c_zero_pad = false;
+#endif
+	static FIXEDSTRING_CONSTEXPR size_type safe_len(const_pointer str)
 	{
-		return str == NULL ? 0u : static_cast<size_type>(strlen(str));
+		return str == NULL ? 0u : static_cast<size_type>(FixedStringKernels::length(str));
 	}
 	static constexpr bool is_valid(const_pointer data, size_type len)
 	{
@@ -112,34 +533,64 @@ private:
 	{
 		return data == NULL || len == 0u;
 	}
+#ifdef FIXEDSTRING_HAS_CONSTEXPR
+public: //C++20: data is public so FixedString is a structural type & can be a template parameter. Do NOT access directly!
+#else
 private:
-	// The Length limited to [0 .. c_storage_size-2]
+#endif
+	// The Length limited to [0 .. capacity()]
 	//	We store to speed up string operations
-	unsigned char m_len;
+	length_type m_len;
 	//The actual string data
-	char_type m_str[c_storage_size - 1];
+	char_type m_str[c_storage_size - sizeof(length_type)];
 public:
-	FixedString() :m_len(0u), m_str{ 0 } {} //Make sure null added
-	FixedString(const_pointer str) { assign(str); }
-	FixedString(const_pointer lpch, size_type len) { assign(lpch, len); }
-	FixedString(char_type c, size_type repeat = 1) { assign(repeat, c); }
-	template<size_type c_storage_size2>
-	FixedString(const FixedString<c_storage_size2>& rhs) { assign(rhs); }
+	FIXEDSTRING_CONSTEXPR FixedString() { init_storage(); m_str[0] = 0; } //Only the null is needed, unless FIXEDSTRING_ZERO_PAD
+	//Only the used bytes are copied, see copy_bytes()
+	FIXEDSTRING_CONSTEXPR FixedString(const FixedString& rhs) { copy_from(rhs); }
+	FIXEDSTRING_CONSTEXPR FixedString(const_pointer str) { init_storage(); assign(str); }
+	FIXEDSTRING_CONSTEXPR FixedString(const_pointer lpch, size_type len) { init_storage(); assign(lpch, len); }
+	FIXEDSTRING_CONSTEXPR FixedString(char_type c, size_type repeat = 1) { init_storage(); assign(repeat, c); }
+	FIXEDSTRING_CONSTEXPR FixedString(FixedStringView v) { init_storage(); assign(v); }
+#ifndef ARDUINO
+	//explicit (as std::string) else ambiguous with the FixedString & FixedStringView overloads
+	explicit FIXEDSTRING_CONSTEXPR FixedString(std::string_view s) { init_storage(); assign(s.data(), static_cast<size_type>(s.size())); }
+#endif
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR FixedString(const FixedString<c_storage_size2, OverrunPolicy2>& rhs) { init_storage(); assign(rhs); }
+	//a + b + ... written in one pass, see FixedStringConcat
+	template<size_type c_parts, typename TString>
+	FIXEDSTRING_CONSTEXPR FixedString(const FixedStringConcat<c_parts, TString>& expr) { init_storage(); concat(expr); }
 	//Numeric
 	//Numeric Set
-	explicit FixedString(char i, Radix r) { assign(i, r); }
-	explicit FixedString(unsigned char u, Radix r) { assign(u, r); }
-	explicit FixedString(int i, Radix r = base10) { assign(i, r); }
-	explicit FixedString(unsigned int u, Radix r = base10) { assign(u, r); }
-	explicit FixedString(long l, Radix r = base10) { assign(l, r); }
-	explicit FixedString(unsigned long u, Radix r = base10) { assign(u, r); }
-	explicit FixedString(float f, size_type decPlaces = 2) { assign(f, decPlaces); }
-	explicit FixedString(double d, size_type decPlaces = 2) { assign(d, decPlaces); }
+	explicit FixedString(char i, Radix r) { init_storage(); assign(i, r); }
+	explicit FixedString(unsigned char u, Radix r) { init_storage(); assign(u, r); }
+	explicit FixedString(int i, Radix r = base10) { init_storage(); assign(i, r); }
+	explicit FixedString(unsigned int u, Radix r = base10) { init_storage(); assign(u, r); }
+	explicit FixedString(long l, Radix r = base10) { init_storage(); assign(l, r); }
+	explicit FixedString(unsigned long u, Radix r = base10) { init_storage(); assign(u, r); }
+#ifndef ARDUINO
+	explicit FixedString(long long i, Radix r = base10) { init_storage(); assign(i, r); }
+	explicit FixedString(unsigned long long u, Radix r = base10) { init_storage(); assign(u, r); }
+#endif
+	explicit FixedString(float f, size_type decPlaces = 2) { init_storage(); assign(f, decPlaces); }
+	explicit FixedString(double d, size_type decPlaces = 2) { init_storage(); assign(d, decPlaces); }
 	//overloaded assignment
-	FixedString& operator=(const_pointer str) { assign(str); return *this; }
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(const FixedString& rhs)
+	{
+		if (!is_self(rhs))
+			copy_from(rhs);
+		return *this;
+	}
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(const_pointer str) { assign(str); return *this; }
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(FixedStringView v) { assign(v); return *this; }
+#ifndef ARDUINO
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(std::string_view s) { assign(s); return *this; }
+#endif
 	FixedString& operator=(char_type c) { assign(c); return *this; }
-	template<size_type c_storage_size2>
-	FixedString& operator=(const FixedString<c_storage_size2>& rhs) { assign(rhs); return *this; }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(const FixedString<c_storage_size2, OverrunPolicy2>& rhs) { assign(rhs); return *this; }
+	template<size_type c_parts, typename TString>
+	FIXEDSTRING_CONSTEXPR FixedString& operator=(const FixedStringConcat<c_parts, TString>& expr) { assign(expr); return *this; }
 	//Numeric
 	template<typename Num>
 	FixedString& operator=(Num num) { assign(num); return *this; }
@@ -151,21 +602,92 @@ public:
 #endif
 public:
 	//The string length - we return local cached value for speed
-	size_type length()const { return m_len; }
+	FIXEDSTRING_CONSTEXPR size_type length()const { return m_len; }
 	//No of free chars available for concat
-	size_type available()const { return capacity() - length(); }
-	bool full()const { return available() == 0u; }
-	bool empty()const { return length() == 0u; }
+	FIXEDSTRING_CONSTEXPR size_type available()const { return capacity() - length(); }
+	FIXEDSTRING_CONSTEXPR bool full()const { return available() == 0u; }
+	FIXEDSTRING_CONSTEXPR bool empty()const { return length() == 0u; }
+	//Moves count strings to uninitialised (or no longer needed) memory, copying only the used
+	//bytes of each - no constructor or destructor is needed, see FixedStringRelocatable.
+	//The ranges must not overlap.
+	static void relocate(FixedString* dest, const FixedString* src, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			copy_bytes(dest + i, src + i);
+	}
+	//Binary format: the length as a varint (FixedStringKernels::put_varint()) then the text, no
+	//null. Neither way rescans the text and any size of string can read what another wrote.
+	static constexpr size_type serialized_max() { return FixedStringKernels::varint_size(capacity()) + capacity(); }
+	size_type serialized_size()const { return FixedStringKernels::varint_size(length()) + length(); }
+	//Bytes written to dest, 0 if size is too small. A short string's record is copied straight
+	//from its own bytes, see serialized_data().
+	size_type serialize(void* dest, size_t size)const
+	{
+		if (size < serialized_size())
+			return 0;
+		char* out = static_cast<char*>(dest);
+		if (const void* record = serialized_data())
+		{
+			memcpy(out, record, 1 + length());
+			return 1 + length();
+		}
+		const size_type n = FixedStringKernels::put_varint(out, length());
+		memcpy(out + n, c_str(), length());
+		return n + length();
+	}
+	//Bytes read from src, 0 if it does not hold a whole record or the text is longer than
+	//capacity() - the string is then unchanged
+	size_type deserialize(const void* src, size_t size)
+	{
+		const char* in = static_cast<const char*>(src);
+		uint32_t len = 0;
+		const size_type n = FixedStringKernels::get_varint(in, size, len);
+		if (n == 0 || !valid_len(len) || size - n < len)
+			return 0;
+		memcpy(m_str, in + n, len);
+		set_len(len);
+		return n + len;
+	}
+	//The string's own bytes when they already are the serialized record (a 1 byte length and
+	//under 128 chars) so can be written out as they are, else NULL
+	const void* serialized_data()const
+	{
+		return sizeof(length_type) == 1 && length() < 0x80u ? static_cast<const void*>(this) : NULL;
+	}
 
 public:
 	//set to a valid empty string
-	void clear() { set_len(0); }
+	FIXEDSTRING_CONSTEXPR void clear() { set_len(0); }
 	//assign
-	bool assign(const_pointer data, size_type len) { clear(); return concat(data, len); }
-	bool assign(const_pointer str) { return assign(str, safe_len(str)); }
-	bool assign(size_type repeat, char_type c) { clear(); return concat(repeat, c); }
-	template<size_type c_storage_size2>
-	bool assign(const FixedString<c_storage_size2>& rhs) { clear(); return concat(rhs); }
+	FIXEDSTRING_CONSTEXPR bool assign(const_pointer data, size_type len) { clear(); return concat(data, len); }
+	FIXEDSTRING_CONSTEXPR bool assign(const_pointer str) { return assign(str, safe_len(str)); }
+	FIXEDSTRING_CONSTEXPR bool assign(FixedStringView v) { return assign(v.data(), v.length()); }
+	FIXEDSTRING_CONSTEXPR bool assign(size_type repeat, char_type c) { clear(); return concat(repeat, c); }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR bool assign(const FixedString<c_storage_size2, OverrunPolicy2>& rhs)
+	{
+		if (is_self(rhs))
+			return true;
+		//Straight copy, the text is already a valid string
+		const auto actual_cnt = get_min(rhs.length(), capacity());
+		FixedStringKernels::move(m_str, rhs.c_str(), actual_cnt);
+		return set_len(actual_cnt, actual_cnt == rhs.length());
+	}
+	template<size_type c_parts, typename TString>
+	FIXEDSTRING_CONSTEXPR bool assign(const FixedStringConcat<c_parts, TString>& expr)
+	{
+		if (!expr.refers_to(m_str, length()))
+		{
+			clear();
+			return concat(expr);
+		}
+		//e.g. s = "x" + s, the parts are read from this string so build it aside
+		FixedString temp;
+		const bool ok = temp.concat(expr);
+		clear();
+		concat(temp.c_str(), temp.length());
+		return ok;
+	}
 #ifdef ARDUINO
 	bool assign(const String& s) { clear(); return concat(s); }
 	bool assign(FlashPtr str)
@@ -180,26 +702,44 @@ public:
 		return set_len(actual_cnt, actual_cnt == prog_len);
 	}
 #endif
-	bool assign(char i, Radix r) { return set_i(i, r); }
-	bool assign(unsigned char u, Radix r) { return set_u(u, r); }
-	bool assign(int i, Radix r = base10) { return set_i(i, r); }
-	bool assign(unsigned int u, Radix r = base10) { return set_u(u, r); }
-	bool assign(long i, Radix r = base10) { return set_l(i, r); }
-	bool assign(unsigned long u, Radix r = base10) { return set_ul(u, r); }
-	bool assign(float f, size_type decPlaces = 2) { return set_f(f, decPlaces); }
-	bool assign(double d, size_type decPlaces = 2) { return set_f(d, decPlaces); }
+	//Numeric - the number must fit in full or the string is left empty
+	bool assign(char i, Radix r) { clear(); return append_number(i, r, false); }
+	bool assign(unsigned char u, Radix r) { clear(); return append_number(u, r, false); }
+	bool assign(int i, Radix r = base10) { clear(); return append_number(i, r, false); }
+	bool assign(unsigned int u, Radix r = base10) { clear(); return append_number(u, r, false); }
+	bool assign(long i, Radix r = base10) { clear(); return append_number(i, r, false); }
+	bool assign(unsigned long u, Radix r = base10) { clear(); return append_number(u, r, false); }
+#ifndef ARDUINO
+	bool assign(long long i, Radix r = base10) { clear(); return append_number(i, r, false); }
+	bool assign(unsigned long long u, Radix r = base10) { clear(); return append_number(u, r, false); }
+#endif
+	bool assign(float f, size_type decPlaces = 2) { clear(); return append_float(f, decPlaces + 2, decPlaces, false); }
+	bool assign(double d, size_type decPlaces = 2) { clear(); return append_float(d, decPlaces + 2, decPlaces, false); }
 	//concat
-	bool concat(const_pointer data, size_type len) { return handle_insert(length(), data, len); }
-	bool concat(const_pointer str) { return handle_insert(length(), str); }
-	bool concat(char_type c) { return handle_insert(length(), 1, c); }
-	bool concat(size_type repeat, char_type c) { return handle_insert(length(), repeat, c); }
-	template<size_type c_storage_size2>
-	bool concat(const FixedString<c_storage_size2>& rhs) { return concat(rhs.begin(), rhs.length()); }
-	//Numeric float
-	bool concat(double d, size_type decPlaces = 2) { return concat(FixedString(d, decPlaces)); }
-	//Numeric integer
+	FIXEDSTRING_CONSTEXPR bool concat(const_pointer data, size_type len) { return handle_insert(length(), data, len); }
+	FIXEDSTRING_CONSTEXPR bool concat(const_pointer str) { return handle_insert(length(), str); }
+	FIXEDSTRING_CONSTEXPR bool concat(FixedStringView v) { return handle_insert(length(), v.data(), v.length()); }
+#ifndef ARDUINO
+	FIXEDSTRING_CONSTEXPR bool concat(std::string_view s) { return concat(FixedStringView(s)); }//else taken by concat(Num)
+#endif
+	FIXEDSTRING_CONSTEXPR bool concat(char_type c) { return handle_insert(length(), 1, c); }
+	FIXEDSTRING_CONSTEXPR bool concat(size_type repeat, char_type c) { return handle_insert(length(), repeat, c); }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR bool concat(const FixedString<c_storage_size2, OverrunPolicy2>& rhs) { return concat(rhs.begin(), rhs.length()); }
+	//Parts are only read from before length() so an expression using this string is safe
+	template<size_type c_parts, typename TString>
+	FIXEDSTRING_CONSTEXPR bool concat(const FixedStringConcat<c_parts, TString>& expr)
+	{
+		const auto actual_cnt = get_min(available(), expr.length());
+		expr.copy_to(begin() + length(), actual_cnt);
+		return set_len(length() + actual_cnt, actual_cnt == expr.length() && !expr.truncated());
+	}
+	//Numeric float - formatted straight into the string, truncated if it does not fit
+	bool concat(float f, size_type decPlaces = 2) { return append_float(f, decPlaces + 2, decPlaces, true); }
+	bool concat(double d, size_type decPlaces = 2) { return append_float(d, decPlaces + 2, decPlaces, true); }
+	//Numeric integer - digits written straight into the string, truncated if they do not fit
 	template<typename Num>
-	bool concat(Num n, Radix r = base10) { return concat(FixedString(n, r)); }
+	bool concat(Num n, Radix r = base10) { return append_number(n, r, true); }
 	//Special case - overwrite end char if full, otherwise just add
 	bool force_concat(char_type c)
 	{
@@ -209,96 +749,152 @@ public:
 		return true;
 	}
 	template<typename Param>
-	FixedString& operator+=(Param p) { concat(p); return *this; }
+	FIXEDSTRING_CONSTEXPR FixedString& operator+=(Param p) { concat(p); return *this; }
 	template<size_type c_storage_size2>
-	FixedString& operator+=(const FixedString& s) { concat(s); return *this; }
+	FIXEDSTRING_CONSTEXPR FixedString& operator+=(const FixedString& s) { concat(s); return *this; }
+	//{} style format - see FixedStringFormat
+	//Returns false if the result was truncated (or the format is invalid)
+	template<typename... Args>
+	bool fmt(FixedStringFormat<typename FixedStringIdentity<Args>::type...> f, const Args&... args)
+	{
+		clear();
+		return concat_fmt(f, args...);
+	}
+	template<typename... Args>
+	bool concat_fmt(FixedStringFormat<typename FixedStringIdentity<Args>::type...> f, const Args&... args)
+	{
+		if (!f.valid())
+			return false;
+		bool ok = true;
+		unsigned int index = 0;
+		//Stop at the first field that does not fit
+		using expand = int[];
+		(void)expand { 0, (ok = ok && concat_field(f.text(), f.field(index++), args), 0)... };
+		return ok && concat_field_text(f.text(), f.field(index));
+	}
 	//Support for C style sprintf format
 	//NB. %f floating point output doen't work by default as it adds a lot of code to a sketch
 	//		
-	void format(const_pointer fmt, ...)
+	//Returns false if the result was truncated (or on a format error)
+	bool format(const_pointer fmt, ...)
 	{
 		clear();
 		if (safe_len(fmt) == 0)
-			return;
+			return true;
 		va_list args;
 		va_start(args, fmt);
-		formatV(fmt, args);
+		const bool ok = formatV(fmt, args);
 		va_end(args);
+		return ok;
 	}
 #ifdef ARDUINO
 	bool concat(const String& s) { return handle_insert(length(), s.c_str(), s.length()); }
 	bool concat(FlashPtr str) { return concat(FixedString(str)); }
 	FixedString& operator+=(const String& s) { concat(s); return *this; }
 	FixedString& operator+=(FlashPtr str) { concat(str); return *this; }
-	void format(FlashPtr f_fmt, ...)
+	bool format(FlashPtr f_fmt, ...)
 	{
 		clear();
 		FixedString fmt(f_fmt);
 		if (fmt.empty())
-			return;
+			return true;
 		va_list args;
 		va_start(args, fmt.m_str);
-		formatV(fmt.m_str, args);
+		const bool ok = formatV(fmt.m_str, args);
 		va_end(args);
+		return ok;
 	}
 #endif
 
 	//string comparison
-	int compareTo(const FixedString& rhs)const
+	FIXEDSTRING_CONSTEXPR int compareTo(const FixedString& rhs)const
 	{
-		return (&rhs == this)
+		return is_self(rhs)
 			? 0
-			: compareTo(rhs.c_str(), rhs.length());
+			: compare_data(rhs.c_str(), rhs.length());
 	}
-	template<int c_storage_size2>
-	int compareTo(const FixedString<c_storage_size2>& rhs)const { return compareTo(rhs.c_str(), rhs.length()); }
-	int compareTo(const_pointer rhs)const { return compareTo(rhs, safe_len(rhs)); }
-	int compareTo(const_pointer rhs, size_type len)const
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR int compareTo(const FixedString<c_storage_size2, OverrunPolicy2>& rhs)const { return compare_data(rhs.c_str(), rhs.length()); }
+	FIXEDSTRING_CONSTEXPR int compareTo(const_pointer rhs)const { return compareTo(rhs, safe_len(rhs)); }
+	FIXEDSTRING_CONSTEXPR int compareTo(FixedStringView rhs)const { return compare_data(rhs.data(), rhs.length()); }
+	FIXEDSTRING_CONSTEXPR int compareTo(const_pointer rhs, size_type len)const
 	{
-		if (is_empty(rhs, len))
-			return empty() ? 0 : charAt(0);
-		if (empty())
-			return -rhs[0];
-		return strncmp(c_str(), rhs, get_max(length(), len));
+		if (!is_valid(rhs, len))
+			return empty() ? 0 : 1;
+		return compare_data(rhs, len);
 	}
-	bool operator<(const FixedString& rhs)const { return compareTo(rhs) < 0; }
-	bool operator>(const FixedString& rhs)const { return compareTo(rhs) > 0; }
-	bool operator<=(const FixedString& rhs)const { return compareTo(rhs) <= 0; }
-	bool operator>=(const FixedString& rhs)const { return compareTo(rhs) >= 0; }
+	FIXEDSTRING_CONSTEXPR bool operator<(const FixedString& rhs)const { return compareTo(rhs) < 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>(const FixedString& rhs)const { return compareTo(rhs) > 0; }
+	FIXEDSTRING_CONSTEXPR bool operator<=(const FixedString& rhs)const { return compareTo(rhs) <= 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>=(const FixedString& rhs)const { return compareTo(rhs) >= 0; }
+
+	FIXEDSTRING_CONSTEXPR bool operator<(const_pointer rhs)const { return compareTo(rhs) < 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>(const_pointer rhs)const { return compareTo(rhs) > 0; }
+	FIXEDSTRING_CONSTEXPR bool operator<=(const_pointer rhs)const { return compareTo(rhs) <= 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>=(const_pointer rhs)const { return compareTo(rhs) >= 0; }
 
-	bool operator<(const_pointer rhs)const { return compareTo(rhs) < 0; }
-	bool operator>(const_pointer rhs)const { return compareTo(rhs) > 0; }
-	bool operator<=(const_pointer rhs)const { return compareTo(rhs) <= 0; }
-	bool operator>=(const_pointer rhs)const { return compareTo(rhs) >= 0; }
+	FIXEDSTRING_CONSTEXPR bool operator<(FixedStringView rhs)const { return compareTo(rhs) < 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>(FixedStringView rhs)const { return compareTo(rhs) > 0; }
+	FIXEDSTRING_CONSTEXPR bool operator<=(FixedStringView rhs)const { return compareTo(rhs) <= 0; }
+	FIXEDSTRING_CONSTEXPR bool operator>=(FixedStringView rhs)const { return compareTo(rhs) >= 0; }
 
 	//equals
-	bool equals(const_pointer rhs, size_type len)const { return equals(rhs, len, false); }
+	FIXEDSTRING_CONSTEXPR bool equals(const_pointer rhs, size_type len)const { return equals(rhs, len, false); }
 	template<size_type c_storage_size2>
-	bool equals(const FixedString& rhs)const { return equals(rhs, false); }
-	bool equals(const_pointer rhs)const { return equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool equals(const FixedString& rhs)const { return equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool equals(const_pointer rhs)const { return equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool equals(FixedStringView rhs)const { return equals_data(rhs.data(), rhs.length(), false); }
+
+	FIXEDSTRING_CONSTEXPR bool operator==(const_pointer rhs)const { return equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool operator!=(const_pointer rhs)const { return !equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool operator==(FixedStringView rhs)const { return equals(rhs); }
+	FIXEDSTRING_CONSTEXPR bool operator!=(FixedStringView rhs)const { return !equals(rhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator==(FixedStringView lhs, const FixedString& rhs) { return rhs.equals(lhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(FixedStringView lhs, const FixedString& rhs) { return !rhs.equals(lhs); }
+#ifndef ARDUINO
+	//Exact matches, otherwise ambiguous with the FixedStringView operators
+	FIXEDSTRING_CONSTEXPR bool operator==(std::string_view rhs)const { return equals(rhs); }
+	FIXEDSTRING_CONSTEXPR bool operator!=(std::string_view rhs)const { return !equals(rhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator==(std::string_view lhs, const FixedString& rhs) { return rhs.equals(lhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(std::string_view lhs, const FixedString& rhs) { return !rhs.equals(lhs); }
+#endif
 
-	bool operator==(const_pointer rhs)const { return equals(rhs, false); }
-	bool operator!=(const_pointer rhs)const { return !equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool operator==(const FixedString& rhs)const { return equals(rhs, false); }
+	FIXEDSTRING_CONSTEXPR bool operator!=(const FixedString& rhs)const { return !equals(rhs, false); }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR bool operator==(const FixedString<c_storage_size2, OverrunPolicy2>& rhs)const { return equals(rhs); }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	FIXEDSTRING_CONSTEXPR bool operator!=(const FixedString<c_storage_size2, OverrunPolicy2>& rhs)const { return !equals(rhs); }
 
-	bool operator==(const FixedString& rhs)const { return equals(rhs, false); }
-	bool operator!=(const FixedString& rhs)const { return !equals(rhs, false); }
-	template<size_type c_storage_size2>
-	bool operator==(const FixedString<c_storage_size2>& rhs)const { return equals(rhs); }
-	template<size_type c_storage_size2>
-	bool operator!=(const FixedString<c_storage_size2>& rhs)const { return !equals(rhs); }
+	//ASCII case insensitive
+	FIXEDSTRING_CONSTEXPR bool equalsIgnoreCase(const FixedString& rhs)const { return equals(rhs, true); }
+	FIXEDSTRING_CONSTEXPR bool equalsIgnoreCase(const_pointer rhs)const { return equals(rhs, true); }
+	FIXEDSTRING_CONSTEXPR bool equalsIgnoreCase(FixedStringView rhs)const { return equals_data(rhs.data(), rhs.length(), true); }
+	FIXEDSTRING_CONSTEXPR int compareToIgnoreCase(const FixedString& rhs)const { return compare_data_ignore_case<c_block16>(rhs.c_str(), rhs.length()); }
+	FIXEDSTRING_CONSTEXPR int compareToIgnoreCase(const_pointer rhs)const { return compareToIgnoreCase(rhs, safe_len(rhs)); }
+	FIXEDSTRING_CONSTEXPR int compareToIgnoreCase(const_pointer rhs, size_type len)const
+	{
+		return is_valid(rhs, len) ? compare_data_ignore_case(rhs, len) : 1;
+	}
+	FIXEDSTRING_CONSTEXPR int compareToIgnoreCase(FixedStringView rhs)const { return compare_data_ignore_case(rhs.data(), rhs.length()); }
 
-	bool equalsIgnoreCase(const FixedString& rhs)const { return equals(rhs, true); }
-	bool equalsIgnoreCase(const_pointer rhs)const { return equals(rhs, true); }
+	//Hash of the text, equal to FixedStringKernels::hash(c_str(), length()) - see FixedStringHash
+	FIXEDSTRING_CONSTEXPR size_t hash()const { return FixedStringKernels::hash(c_str(), get_min(length(), capacity())); }//min() tells the optimiser the bound
 
 	//Data access
 	//operator const_pointer()const { return m_str; }
-	const_pointer c_str()const { return m_str; }
-	const_pointer begin()const { return m_str; }
-	const_pointer end()const { return begin() + length(); }
-	pointer begin() { return m_str; }
-	pointer	end() { return begin() + length(); }
-	char_type charAt(size_type index)const { return valid_pos(index) ? m_str[index] : 0; }
-	char_type operator[](size_type index)const { return charAt(index); }
+	FIXEDSTRING_CONSTEXPR const_pointer c_str()const { return m_str; }
+	FIXEDSTRING_CONSTEXPR const_pointer begin()const { return m_str; }
+	FIXEDSTRING_CONSTEXPR const_pointer end()const { return begin() + length(); }
+	FIXEDSTRING_CONSTEXPR pointer begin() { return m_str; }
+	FIXEDSTRING_CONSTEXPR pointer	end() { return begin() + length(); }
+	//Views carry the length so nothing needs to strlen() the text again
+	FIXEDSTRING_CONSTEXPR operator FixedStringView()const { return view(); }
+#ifndef ARDUINO
+	FIXEDSTRING_CONSTEXPR explicit operator std::string_view()const { return std::string_view(c_str(), length()); }
+#endif
+	FIXEDSTRING_CONSTEXPR char_type charAt(size_type index)const { return valid_pos(index) ? m_str[index] : 0; }
+	FIXEDSTRING_CONSTEXPR char_type operator[](size_type index)const { return charAt(index); }
 	void setCharAt(size_type index, char_type c)
 	{
 		if (!valid_pos(index))
@@ -308,7 +904,11 @@ public:
 			set_len(index);//shrink
 	}
 	//Call if string modified externally via begin()/end()
-	void update_len() { set_len(get_min(safe_len(c_str()), capacity())); }
+	void update_len()
+	{
+		set_len(get_min(safe_len(c_str()), capacity()));
+		zero_free();
+	}
 
 	void getBytes(unsigned char* buf, size_type bufsize, size_type index = 0) const
 	{
@@ -331,80 +931,64 @@ public:
 	}
 
 	//search
-	bool startsWith(const_pointer s, size_type offset = 0)const
+	FIXEDSTRING_CONSTEXPR bool startsWith(const_pointer s, size_type offset = 0)const { return startsWith(FixedStringView(s), offset); }
+	FIXEDSTRING_CONSTEXPR bool startsWith(FixedStringView s, size_type offset = 0)const
 	{
-		const auto rhs_len = safe_len(s);
-		if (rhs_len == 0 || (offset + rhs_len) > length())
+		if (s.empty() || (offset + s.length()) > length())
 			return false;
-		return strncmp(data_offset(offset), s, rhs_len) == 0;
+		return FixedStringKernels::compare(data_offset(offset), s.data(), s.length()) == 0;
 	}
-	bool endsWith(const_pointer s)const
+	FIXEDSTRING_CONSTEXPR bool endsWith(const_pointer s)const { return endsWith(FixedStringView(s)); }
+	FIXEDSTRING_CONSTEXPR bool endsWith(FixedStringView s)const
 	{
-		const auto rhs_len = safe_len(s);
-		if (rhs_len == 0 || rhs_len > length())
+		if (s.empty() || s.length() > length())
 			return false;
-		return strncmp(data_offset(length() - rhs_len), s, rhs_len) == 0;
+		return FixedStringKernels::compare(data_offset(length() - s.length()), s.data(), s.length()) == 0;
 	}
-	int indexOf(char_type c, size_type start_pos = 0)const
+	FIXEDSTRING_CONSTEXPR int indexOf(char_type c, size_type start_pos = 0)const
 	{
 		if (!valid_pos(start_pos))
 			return -1;
-		const_pointer p = strchr(data_offset(start_pos), c);
-		if (p == NULL)
-			return -1;
-		return static_cast<int>(p - begin());
+		return to_index(FixedStringKernels::find_char<c_simd>(data_offset(start_pos), length() - start_pos, c));
 	}
-	int indexOf(const_pointer s, size_type start_pos = 0)const
+	FIXEDSTRING_CONSTEXPR int indexOf(const_pointer s, size_type start_pos = 0)const { return indexOf(FixedStringView(s), start_pos); }
+	FIXEDSTRING_CONSTEXPR int indexOf(FixedStringView s, size_type start_pos = 0)const
 	{
 		if (!valid_pos(start_pos))
 			return -1;
-		const auto rhs_len = safe_len(s);
-		if (rhs_len == 0 || (start_pos + rhs_len) > length())
+		if (s.empty() || (start_pos + s.length()) > length())
 			return -1;
-		const_pointer p = strstr(data_offset(start_pos), s);
-		if (p == NULL)
-			return -1;
-		return static_cast<int>(p - begin());
+		return to_index(FixedStringKernels::find_str<c_simd>(data_offset(start_pos), length() - start_pos, s.data(), s.length()));
 	}
-	int lastIndexOf(char_type c)const
+	FIXEDSTRING_CONSTEXPR int lastIndexOf(char_type c)const
 	{
 		if (empty() || c == 0)
 			return -1;
-		const_pointer p = strrchr(c_str(), c);
-		if (p == NULL)
-			return -1;
-		return static_cast<int>(p - begin());
+		return to_index(FixedStringKernels::find_last_char<c_simd>(begin(), length(), c));
 	}
-	int lastIndexOf(char_type c, size_type from_pos)const
+	FIXEDSTRING_CONSTEXPR int lastIndexOf(char_type c, size_type from_pos)const
 	{
 		if (from_pos >= length())
 			return lastIndexOf(c);
 		if (empty() || c == 0)
 			return -1;
-		return substring(0, from_pos + 1).lastIndexOf(c);
+		return to_index(FixedStringKernels::find_last_char<c_simd>(begin(), from_pos + 1, c));
 	}
-	int lastIndexOf(const_pointer s, size_type from_pos = npos)const
+	FIXEDSTRING_CONSTEXPR int lastIndexOf(const_pointer s, size_type from_pos = npos)const { return lastIndexOf(FixedStringView(s), from_pos); }
+	FIXEDSTRING_CONSTEXPR int lastIndexOf(FixedStringView s, size_type from_pos = npos)const
 	{
 		if (empty())
 			return -1;
-		const auto rhs_len = safe_len(s);
+		const auto rhs_len = s.length();
 		if (rhs_len == 0 || rhs_len > length())
 			return -1;
 		if (from_pos >= length())
 			from_pos = length() - 1;//end
-		int found = -1;
-		for (const_pointer p = begin(); p <= data_offset(from_pos); p++)
-		{
-			p = strstr(p, s);
-			if (p == NULL)
-				break;
-			auto index = static_cast<int>(p - begin());
-			if (static_cast<size_type>(index) <= from_pos)
-				found = index;
-		}
-		return found;
+		//Only search the range in which a match can start at or before from_pos
+		const auto search_len = get_min(length(), from_pos + rhs_len);
+		return to_index(FixedStringKernels::find_last_str<c_simd>(begin(), search_len, s.data(), rhs_len));
 	}
-	FixedString substring(size_type left, size_type right = npos)const
+	FIXEDSTRING_CONSTEXPR FixedString substring(size_type left, size_type right = npos)const
 	{
 		if (right == npos)
 			right = length();
@@ -421,6 +1005,12 @@ public:
 		return FixedString(data_offset(left), right - left);
 	}
 
+	//Zero copy - the views are only valid until the string is next modified
+	FIXEDSTRING_CONSTEXPR FixedStringView view()const { return FixedStringView(c_str(), length()); }
+	FIXEDSTRING_CONSTEXPR FixedStringView view(size_type left, size_type right = npos)const { return view().substring(left, right); }
+	FIXEDSTRING_CONSTEXPR FixedStringSplit split(char_type delim)const { return view().split(delim); }
+	FIXEDSTRING_CONSTEXPR FixedStringTokens tokenize(const_pointer delims)const { return view().tokenize(delims); }
+
 public:
 	void replace(char_type c, char_type new_c)
 	{
@@ -432,29 +1022,30 @@ public:
 				p = new_c;
 		}
 	}
-	void replace(const_pointer s, const_pointer new_s)
+	//Returns false if the result was truncated
+	bool replace(const_pointer s, const_pointer new_s)
 	{
-		if (empty())
-			return;
-		auto src_len = safe_len(s);
-		if (src_len == 0)
-			return;
-		auto repl_len = safe_len(new_s);
-		//Drop out if same
-		if (src_len == repl_len && strcmp(s, new_s) == 0)
-			return;
-		for (auto index = indexOf(s); valid_pos(index); index = indexOf(s, index))
-		{
-			if (repl_len > 0)
-			{
-				handle_replace(index, src_len, new_s, repl_len);
-				index += repl_len;	//Move to end of this replace string ready for next search
-			}
-			else
-				remove(index, src_len);
-			if (!valid_pos(index))//Drop out if index over the end
-				break;
-		}
+		bool complete = true;
+		handle_replace_all(s, safe_len(s), new_s, safe_len(new_s), complete);
+		return complete;
+	}
+	bool replace(FixedStringView s, FixedStringView new_s)
+	{
+		bool complete = true;
+		handle_replace_all(s.data(), s.length(), new_s.data(), new_s.length(), complete);
+		return complete;
+	}
+	//Replace every occurrence of s, returns the number of matches replaced
+	//If the result does not fit it is truncated at capacity()
+	size_type replace_all(const_pointer s, const_pointer new_s)
+	{
+		bool complete = true;
+		return handle_replace_all(s, safe_len(s), new_s, safe_len(new_s), complete);
+	}
+	size_type replace_all(FixedStringView s, FixedStringView new_s)
+	{
+		bool complete = true;
+		return handle_replace_all(s.data(), s.length(), new_s.data(), new_s.length(), complete);
 	}
 	void remove(size_type index) { if (index < length()) set_len(index); }
 	void remove(size_type index, size_type cnt)
@@ -468,34 +1059,46 @@ public:
 		memmove(begin() + index, begin() + index + actual_cnt, max_remove_cnt - actual_cnt + 1);//shift rem chars down (including null char)
 		set_len(length() - actual_cnt);
 	}
-	void insert(size_type index, const_pointer str) { handle_insert(index, str); }
-	void insert(size_type index, const_pointer data, size_type len) { handle_insert(index, data, len); }
-	void insert(size_type index, size_type repeat, char_type c) { handle_insert(index, repeat, c); }
-	void toLowerCase()
+	//Returns false if truncated (or index is past the end)
+	bool insert(size_type index, const_pointer str) { return handle_insert(index, str); }
+	bool insert(size_type index, const_pointer data, size_type len) { return handle_insert(index, data, len); }
+	bool insert(size_type index, FixedStringView v) { return handle_insert(index, v.data(), v.length()); }
+	bool insert(size_type index, size_type repeat, char_type c) { return handle_insert(index, repeat, c); }
+	//ASCII only ("C" locale), a block at a time
+	FIXEDSTRING_CONSTEXPR void toLowerCase() { FixedStringKernels::to_lower<capacity()>(begin(), length()); }
+	FIXEDSTRING_CONSTEXPR void toUpperCase() { FixedStringKernels::to_upper<capacity()>(begin(), length()); }
+	//Drop leading and/or trailing white space (' ', '\t'-'\r'). Only the text kept is moved,
+	//trim_right() moves nothing
+	FIXEDSTRING_CONSTEXPR void trim()
 	{
-		for (char_type& p : *this)
-			p = static_cast<char_type>(tolower(p));
+		const_pointer last = FixedStringKernels::find_last_not_space<capacity()>(begin(), length());
+		const size_type keep = last == NULL ? 0 : static_cast<size_type>(last - begin()) + 1;
+		const_pointer first = FixedStringKernels::find_not_space<capacity()>(begin(), keep);
+		const size_type skip = first == NULL ? keep : static_cast<size_type>(first - begin());
+		if (skip > 0)
+			FixedStringKernels::move(begin(), data_offset(skip), keep - skip);
+		set_len(keep - skip);
 	}
-	void toUpperCase()
+	FIXEDSTRING_CONSTEXPR void trim_left()
 	{
-		for (char_type& p : *this)
-			p = static_cast<char_type>(toupper(p));
+		const_pointer first = FixedStringKernels::find_not_space<capacity()>(begin(), length());
+		const size_type skip = first == NULL ? length() : static_cast<size_type>(first - begin());
+		if (skip > 0)
+		{
+			FixedStringKernels::move(begin(), data_offset(skip), length() - skip);
+			set_len(length() - skip);
+		}
 	}
-	void trim()
+	FIXEDSTRING_CONSTEXPR void trim_right()
 	{
-		if (empty())
-			return;
-		const_pointer start = begin();
-		const_pointer last = end() - 1;
-		while (isspace(*start))
-			start++;
-		while (isspace(*last) && last >= start)last--;
-		if (start > begin())
-			remove(0, static_cast<size_type>(start - begin()));
-		set_len(static_cast<size_type>(last - start + 1));
+		const_pointer last = FixedStringKernels::find_last_not_space<capacity()>(begin(), length());
+		set_len(last == NULL ? 0 : static_cast<size_type>(last - begin()) + 1);
 	}
 public:
 	//Numeric parsing
+	//The to/get functions are atol()/atof() compatible: leading space and a '+' are skipped
+	//and the value is the number at the start, but get_ is only true if the whole text is a
+	//number that fits. parse() & parse_list() are as FixedStringView
 	long	toInt()const { return to_int<long>(); }
 	float	toFloat()const { return to_float<float>(); }
 	double	toDouble()const { return to_float<double>(); }
@@ -510,37 +1113,49 @@ public:
 	bool get_float(T& d)const
 	{
 		d = 0.0f;
-		if (empty())
-			return false;
-		d = static_cast<T>(::atof(c_str()));
-		return !isnan(d);
+		return get_number(d, base10) && !isnan(d);
 	}
 	template<typename T = int>
-	auto to_int()const -> T
+	auto to_int(Radix radix = base10)const -> T
 	{
 		T i = 0;
-		get_int(i);
+		get_int(i, radix);
 		return i;
 	}
 	template<typename T = int>
-	bool get_int(T& i)const
+	bool get_int(T& i, Radix radix = base10)const
 	{
 		i = 0;
-		if (empty())
-			return false;
-		i = static_cast<T>(::atol(c_str()));
-		return true;
+		return get_number(i, radix);
+	}
+	template<typename T>
+	FixedStringParse parse(T& value, Radix radix = base10)const { return view().parse(value, radix); }
+	template<typename T>
+	size_type parse_list(T* values, size_type max, char_type delim = ',', Radix radix = base10, FixedStringParse* result = NULL)const
+	{
+		return view().parse_list(values, max, delim, radix, result);
 	}
 
 private:
 	//helpers
-	bool valid_pos(size_type index)const { return index < length(); }
-	const_pointer data_offset(size_type off)const { return begin() + off; }
-	bool handle_insert(size_type index, const_pointer str, bool allowPartial = true)
+	template<typename T>
+	bool get_number(T& value, Radix radix)const
+	{
+		FixedStringView text = view();
+		text.trim();
+		if (!text.empty() && text[0] == '+')
+			text = text.substring(1);
+		const FixedStringParse res = text.parse(value, radix);
+		return res.ok() && res.pos == text.length();
+	}
+	FIXEDSTRING_CONSTEXPR bool valid_pos(size_type index)const { return index < length(); }
+	FIXEDSTRING_CONSTEXPR const_pointer data_offset(size_type off)const { return begin() + off; }
+	FIXEDSTRING_CONSTEXPR int to_index(const_pointer p)const { return p == NULL ? -1 : static_cast<int>(p - begin()); }
+	FIXEDSTRING_CONSTEXPR bool handle_insert(size_type index, const_pointer str, bool allowPartial = true)
 	{
 		return handle_insert(index, str, safe_len(str), allowPartial);
 	}
-	bool handle_insert(size_type index, const_pointer data, size_type len, bool allowPartial = true)
+	FIXEDSTRING_CONSTEXPR bool handle_insert(size_type index, const_pointer data, size_type len, bool allowPartial = true)
 	{
 		if (index > length())
 			return false;
@@ -553,11 +1168,11 @@ private:
 
 		const auto actual_cnt = get_min(available(), len);
 		if (index < length())
-			memmove(begin() + index + actual_cnt, data_offset(index), length() - index);//shift rem chars up (including null char)
-		memcpy(begin() + index, data, actual_cnt);//copy data
+			FixedStringKernels::move(begin() + index + actual_cnt, data_offset(index), length() - index);//shift rem chars up (including null char)
+		FixedStringKernels::move(begin() + index, data, actual_cnt);//copy data
 		return set_len(length() + actual_cnt, actual_cnt == len);
 	}
-	bool handle_insert(size_type index, size_type repeat, char_type c)
+	FIXEDSTRING_CONSTEXPR bool handle_insert(size_type index, size_type repeat, char_type c)
 	{
 		if (index > length())
 			return false;
@@ -567,54 +1182,208 @@ private:
 			return notify_overrun();
 		const auto actual_cnt = get_min(available(), repeat);
 		if (index < length())
-			memmove(begin() + index + actual_cnt, data_offset(index), length() - index);//shift rem chars up (including null char)
-		for (auto i = 0u; i < actual_cnt; i++)
-			m_str[index + i] = c;
+			FixedStringKernels::move(begin() + index + actual_cnt, data_offset(index), length() - index);//shift rem chars up (including null char)
+		FixedStringKernels::fill(begin() + index, c, actual_cnt);
 		return set_len(length() + actual_cnt, actual_cnt == repeat);
 	}
-	void handle_replace(size_type index, size_type erase_cnt, const_pointer lpch, size_type len)
+	//All matches are found in a single scan and the result is written in place in one pass:
+	//	forwards when the string shrinks (or stays the same size),
+	//	backwards from the precomputed final length when it grows.
+	//complete is set false if the result was truncated
+	size_type handle_replace_all(const_pointer s, size_type src_len, const_pointer new_s, size_type repl_len, bool& complete)
+	{
+		if (empty() || is_empty(s, src_len) || !is_valid(new_s, repl_len))
+			return 0;
+		const bool same = src_len == repl_len && memcmp(s, new_s, src_len) == 0;
+		if (repl_len <= src_len)
+		{
+			size_type cnt = 0;
+			size_type read = 0;
+			size_type write = 0;
+			for (const_pointer p; (p = find_from(read, s, src_len)) != NULL; cnt++)
+			{
+				const auto index = static_cast<size_type>(p - begin());
+				if (!same)
+				{
+					memmove(begin() + write, data_offset(read), index - read);//Unchanged text before match
+					write += index - read;
+					memcpy(begin() + write, new_s, repl_len);
+					write += repl_len;
+				}
+				read = index + src_len;
+			}
+			if (cnt == 0 || same)
+				return cnt;
+			memmove(begin() + write, data_offset(read), length() - read);//Remaining text
+			set_len(write + length() - read);
+			return cnt;
+		}
+		//Growing - mark match positions so the final length is known before anything is moved
+		uint32_t marks[(capacity() + 32) / 32] = {};
+		size_type cnt = 0;
+		for (const_pointer p = find_from(0, s, src_len); p != NULL; p = find_from(static_cast<size_type>(p - begin()) + src_len, s, src_len))
+		{
+			const auto index = static_cast<size_type>(p - begin());
+			marks[index / 32] |= 1ul << (index % 32);
+			cnt++;
+		}
+		if (cnt == 0)
+			return 0;
+		const auto final_len = length() + cnt * (repl_len - src_len);
+		const auto new_len = get_min(final_len, capacity());
+		auto read = length();
+		auto write = final_len;
+		for (auto word = (length() + 31) / 32; word-- > 0 && read != write; )
+		{
+			for (uint32_t bits = marks[word]; bits != 0; )
+			{
+				const auto bit = high_bit(bits);
+				bits &= ~(1ul << bit);
+				const auto index = word * 32 + bit;
+				const auto tail_cnt = read - index - src_len;
+				write -= tail_cnt;
+				copy_clipped(write, data_offset(index + src_len), tail_cnt, new_len);
+				write -= repl_len;
+				copy_clipped(write, new_s, repl_len, new_len);
+				read = index;
+			}
+		}
+		complete = set_len(new_len, final_len == new_len);
+		return cnt;
+	}
+	FIXEDSTRING_CONSTEXPR const_pointer find_from(size_type start_pos, const_pointer s, size_type len)const
+	{
+		return FixedStringKernels::find_str<c_simd>(data_offset(start_pos), length() - start_pos, s, len);
+	}
+	static size_type high_bit(uint32_t bits)
+	{
+#if defined(__GNUC__)
+		return static_cast<size_type>(sizeof(unsigned long) * 8 - 1 - __builtin_clzl(bits));
+#else
+		size_type bit = 31;
+		while ((bits & (1ul << bit)) == 0)
+			bit--;
+		return bit;
+#endif
+	}
+	//Copy to dest_pos, dropping anything at or beyond limit
+	void copy_clipped(size_type dest_pos, const_pointer src, size_type cnt, size_type limit)
 	{
-		if (erase_cnt > 0)
-			remove(index, erase_cnt);
-		handle_insert(index, lpch, len);
+		if (dest_pos < limit)
+			memmove(begin() + dest_pos, src, get_min(cnt, limit - dest_pos));
 	}
 
-	void set_len(size_type len)
+	//Only needed for compile time evaluation where the whole object must be initialised
+	FIXEDSTRING_CONSTEXPR void init_storage()
+	{
+		m_len = 0;
+		if (c_zero_pad || FixedStringKernels::in_constant_evaluation())
+			FixedStringKernels::fill(m_str, 0, sizeof(m_str));
+	}
+	//FIXEDSTRING_ZERO_PAD: zero everything after the end, for when the free space may have been written
+	FIXEDSTRING_CONSTEXPR void zero_free()
+	{
+		if (c_zero_pad)
+			FixedStringKernels::fill(end(), 0, available() + 1);
+	}
+	FIXEDSTRING_CONSTEXPR void set_len(size_type len)
 	{
 		if (!valid_len(len))
 			return;
-		m_len = static_cast<uint8_t>(len);
+		if (c_zero_pad && len < length())
+			FixedStringKernels::fill(m_str + len + 1, 0, get_min(length(), capacity()) - len);
+		m_len = static_cast<length_type>(len);
 		m_str[m_len] = 0;
+		profile_len(len);
 	}
-	bool set_len(size_type len, bool append_ok)
+	FIXEDSTRING_CONSTEXPR bool set_len(size_type len, bool append_ok)
 	{
 		set_len(len);
 		return append_ok || notify_overrun();
 	}
-	bool equals(const FixedString& rhs, bool b_insens)const
+	//NB. Pointers to different objects can't be compared at compile time
+	FIXEDSTRING_CONSTEXPR bool is_self(const FixedString& rhs)const
+	{
+		return !FixedStringKernels::in_constant_evaluation() && &rhs == this;
+	}
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	static constexpr bool is_self(const FixedString<c_storage_size2, OverrunPolicy2>&) { return false; }
+	//A same size copy only needs the length, text and null (copied as whole 16 byte blocks).
+	//A small string is copied whole as a fixed size copy is cheaper, as is a zero padded one to
+	//keep the padding.
+	static void copy_bytes(FixedString* dest, const FixedString* src)
+	{
+		if (c_zero_pad || c_storage_size <= c_copy_whole)
+			memcpy(static_cast<void*>(dest), static_cast<const void*>(src), sizeof(FixedString));
+		else
+		{
+			FixedStringKernels::rt::copy_prefix_block(reinterpret_cast<char*>(dest), reinterpret_cast<const char*>(src),
+				sizeof(length_type) + src->length() + 1, sizeof(FixedString));
+		}
+	}
+	FIXEDSTRING_CONSTEXPR void copy_from(const FixedString& rhs)
+	{
+		if (FixedStringKernels::in_constant_evaluation())
+		{
+			m_len = rhs.m_len;
+			for (size_type i = 0; i < sizeof(m_str); i++)
+				m_str[i] = rhs.m_str[i];
+			return;
+		}
+		copy_bytes(this, &rhs);
+	}
+	//rhs already validated
+	FIXEDSTRING_CONSTEXPR int compare_data(const_pointer rhs, size_type len)const
+	{
+		const auto min_len = get_min(length(), len);
+		const auto res = min_len == 0 ? 0 : FixedStringKernels::compare(c_str(), rhs, min_len);
+		if (res != 0 || length() == len)
+			return res;
+		return length() < len ? -1 : 1;//Shorter string is first
+	}
+	FIXEDSTRING_CONSTEXPR bool equals(const FixedString& rhs, bool b_insens)const
+	{
+		if (is_self(rhs))
+			return true;
+		if (b_insens)
+			return length() == rhs.length() && FixedStringKernels::compare_ignore_case<c_block16>(c_str(), rhs.c_str(), length()) == 0;
+		if (c_zero_pad && !FixedStringKernels::in_constant_evaluation())
+		{
+			//Whole blocks of the storage, including the length
+			return FixedStringKernels::equal_padded(storage_bytes(), rhs.storage_bytes(),
+				sizeof(length_type) + length(), sizeof(FixedString));
+		}
+		return equals_data(rhs.c_str(), rhs.length(), false);
+	}
+	const_pointer storage_bytes()const { return reinterpret_cast<const_pointer>(this); }
+	FIXEDSTRING_CONSTEXPR bool equals(const_pointer rhs, bool b_insens)const { return equals(rhs, safe_len(rhs), b_insens); }
+	FIXEDSTRING_CONSTEXPR bool equals(const_pointer rhs, size_type len, bool b_insens)const
 	{
-		return &rhs == this ||
-			equals(rhs.c_str(), rhs.length(), b_insens);
+		return is_valid(rhs, len) && equals_data(rhs, len, b_insens);
 	}
-	bool equals(const_pointer rhs, bool b_insens)const { return equals(rhs, safe_len(rhs), b_insens); }
-	bool equals(const_pointer rhs, size_type len, bool b_insens)const
+	FIXEDSTRING_CONSTEXPR bool equals_data(const_pointer rhs, size_type len, bool b_insens)const
 	{
 		if (length() != len)
 			return false;
-		if (!is_valid(rhs, len))
-			return false;
+		if (len == 0)
+			return true;
 		if (!b_insens)
-			return compareTo(rhs, len) == 0;
-		//case insensitive
-		for (auto i = 0u; i < len; i++)
-			if (toupper(charAt(i)) != toupper(rhs[i]))
-				return false;
-		return true;
+			return FixedStringKernels::compare(c_str(), rhs, len) == 0;//== 0 lets the compiler use bcmp()
+		return FixedStringKernels::compare_ignore_case(c_str(), rhs, len) == 0;
 	}
-	void formatV(const_pointer fmt, va_list args)
+	template<bool c_rhs_block16 = false>
+	FIXEDSTRING_CONSTEXPR int compare_data_ignore_case(const_pointer rhs, size_type len)const
+	{
+		const auto min_len = get_min(length(), len);
+		const auto res = min_len == 0 ? 0 : FixedStringKernels::compare_ignore_case<c_rhs_block16>(c_str(), rhs, min_len);
+		if (res != 0 || length() == len)
+			return res;
+		return length() < len ? -1 : 1;//Shorter string is first
+	}
+	bool formatV(const_pointer fmt, va_list args)
 	{
 		if (safe_len(fmt) == 0)
-			return;
+			return true;
 		va_list argssave;
 		va_copy(argssave, args);
 		auto ret = vsnprintf(m_str, capacity() + 1, fmt, args);
@@ -622,113 +1391,401 @@ private:
 		if (ret < 0)
 		{
 			clear(); //error
-			return;
+			zero_free();
+			return false;
 		}
 		auto len = static_cast<size_type>(ret);
 		if (len >= 0 && len <= capacity())
+		{
 			set_len(len);
-		else if (len > capacity())
-			set_len(capacity(), false);//Assume overflow so truncate
+			return true;
+		}
+		return set_len(capacity(), false);//Assume overflow so truncate
 	}
 
+	//Numeric append engine
+	//Digits are written directly into m_str, allowPartial keeps the leading digits if the number does not fit
+	bool append_number(char i, Radix r, bool allowPartial) { return append_signed<int, unsigned int>(i, r, allowPartial); }
+	bool append_number(unsigned char u, Radix r, bool allowPartial) { return append_unsigned<unsigned int>(u, r, false, allowPartial); }
+	bool append_number(int i, Radix r, bool allowPartial) { return append_signed<int, unsigned int>(i, r, allowPartial); }
+	bool append_number(unsigned int u, Radix r, bool allowPartial) { return append_unsigned<unsigned int>(u, r, false, allowPartial); }
+	bool append_number(long i, Radix r, bool allowPartial) { return append_signed<long, unsigned long>(i, r, allowPartial); }
+	bool append_number(unsigned long u, Radix r, bool allowPartial) { return append_unsigned<unsigned long>(u, r, false, allowPartial); }
 #ifndef ARDUINO
-	//Non Arduino code simply uses std::to_chars Assumes c++17!
-	//This supports all possible numbers
-	template<typename TInt>
-	bool set_number(char_type buf[], TInt i, Radix r)
-	{
-		//We alloc safe size for buffer -  i.e. max for base 2
-		auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf) - 1, i, r);
-		if (ec != std::errc())
-			return false;
-		auto num_len = static_cast<size_type>(ptr - buf);
-		return handle_insert(length(), buf, num_len, false);
-	}
+	bool append_number(long long i, Radix r, bool allowPartial) { return append_signed<long long, unsigned long long>(i, r, allowPartial); }
+	bool append_number(unsigned long long u, Radix r, bool allowPartial) { return append_unsigned<unsigned long long>(u, r, false, allowPartial); }
 #endif
-
-	bool set_u(unsigned int u, Radix r)
+	template<typename TSigned, typename TUnsigned>
+	bool append_signed(TSigned i, Radix r, bool allowPartial)
 	{
-		clear();//Always start empty
-		char_type buf[1 + 8 * sizeof(unsigned long)]{};//alloc max size for base 2
-#ifdef ARDUINO 
-		return handle_insert(length(), utoa(u, buf, r), false);
+#ifdef ARDUINO
+		//Match itoa()/ltoa(): only base 10 is signed, other bases show the unsigned bit pattern
+		const bool negative = i < 0 && r == base10;
 #else
-		return set_number(buf, u, r);
+		//Match std::to_chars(): signed in all bases
+		const bool negative = i < 0;
 #endif
+		const auto u = negative ? static_cast<TUnsigned>(0u - static_cast<TUnsigned>(i)) : static_cast<TUnsigned>(i);
+		return append_unsigned<TUnsigned>(u, r, negative, allowPartial);
 	}
-	bool set_ul(unsigned long ul, Radix r)
+	template<typename TUnsigned>
+	bool append_unsigned(TUnsigned u, Radix r, bool negative, bool allowPartial)
 	{
-		clear();//Always start empty
-		char_type buf[1 + 8 * sizeof(unsigned long)]{};//alloc max size for base 2
-#ifdef ARDUINO 
-		return handle_insert(length(), ultoa(ul, buf, r), false);
-#else
-		return set_number(buf, ul, r);
-#endif
+		const auto radix = static_cast<unsigned>(r);
+		if (radix < 2 || radix > 36)
+			return false;
+		auto digit_cnt = FixedStringKernels::count_digits(u, radix);
+		const auto num_len = digit_cnt + (negative ? 1 : 0);
+		if (!allowPartial && num_len > capacity())
+			return notify_overrun();
+		const auto actual_cnt = get_min(num_len, available());
+		const auto sign_cnt = (negative && actual_cnt > 0) ? 1u : 0u;
+		pointer p = end();
+		if (sign_cnt > 0)
+			*p++ = '-';
+		//Drop the trailing digits that do not fit
+		for (; digit_cnt > actual_cnt - sign_cnt; digit_cnt--)
+			u /= radix;
+		FixedStringKernels::write_digits(p, u, digit_cnt, radix);
+		return set_len(length() + actual_cnt, actual_cnt == num_len);
 	}
-	bool set_i(int i, Radix r)
+	//Fixed point float formatted as "%width.precf"
+	bool append_float(double f, size_type width, size_type prec, bool allowPartial)
 	{
-		clear();//Always start empty
-		char_type buf[2 + 8 * sizeof(int)]{};//alloc max size for base 2
-#ifdef ARDUINO 
-		return handle_insert(length(), itoa(i, buf, r), false);
+		if (width != 0 && prec >= width)
+			return false;
+		if (!valid_len(width + 2))
+			return notify_overrun();
+#ifdef ARDUINO
+		char_type buf[1 + 4 * sizeof(double)]{}; //Worst case size
+		return handle_insert(length(),
+			dtostrf(f, static_cast<int8_t>(width), static_cast<uint8_t>(prec), buf), allowPartial);
 #else
-		return set_number(buf, i, r);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		//Fast path: std::to_chars straight into the free space
+		auto [ptr, ec] = std::to_chars(end(), begin() + capacity(), f, std::chars_format::fixed, static_cast<int>(prec));
+		if (ec == std::errc())
+		{
+			auto num_len = static_cast<size_type>(ptr - end());
+			if (num_len < width && length() + width <= capacity())
+			{
+				//Right align within width
+				const auto pad = width - num_len;
+				FixedStringKernels::move(end() + pad, end(), num_len);
+				FixedStringKernels::fill(end(), ' ', pad);
+				num_len = width;
+			}
+			if (num_len >= width)
+				return set_len(length() + num_len, true);
+		}
 #endif
-	}
-	bool set_l(long l, Radix r)
-	{
-		clear();//Always start empty
-		char_type buf[2 + 8 * sizeof(long)]{};//alloc max size for base 2
-#ifdef ARDUINO 
-		return handle_insert(length(), ltoa(l, buf, r), false);
-#else
-		return set_number(buf, l, r);
+		//Doesn't fit (or no floating point to_chars) - snprintf straight into the free space, which truncates
+		const auto ret = snprintf(end(), available() + 1, "%*.*f", static_cast<int>(width), static_cast<int>(prec), f);
+		if (ret < 0 || (!allowPartial && static_cast<size_type>(ret) > available()))
+		{
+			zero_free();//remove partial number
+			set_len(length());//restore end char
+			return ret < 0 ? false : notify_overrun();
+		}
+		const auto num_len = static_cast<size_type>(ret);
+		const auto actual_cnt = get_min(num_len, available());
+		const bool ok = set_len(length() + actual_cnt, actual_cnt == num_len);
+		zero_free();//to_chars may have written past the end
+		return ok;
 #endif
 	}
-	bool set_f(double f, size_type decPlaces)
+	//fmt() fields
+	bool concat_field_text(const_pointer fmt, const FixedStringField& f)
 	{
-		return set_f(f, decPlaces + 2, decPlaces);
+		if (!f.text_escaped)
+			return concat(fmt + f.text_pos, f.text_len);
+		for (const_pointer p = fmt + f.text_pos; p < fmt + f.text_pos + f.text_len; p++)
+		{
+			if (!concat(*p))
+				return false;
+			if (*p == '{' || *p == '}')
+				p++;//Skip the second brace
+		}
+		return true;
 	}
-
-	bool set_f(double f, size_type width, size_type prec)
+	template<typename Arg>
+	bool concat_field(const_pointer fmt, const FixedStringField& f, const Arg& arg)
 	{
-		clear();//Always start empty
-		if (prec >= width)
+		if (!concat_field_text(fmt, f))
 			return false;
-		if (!valid_len(width + 2))
-			return notify_overrun();
-		char_type buf[1 + 4 * sizeof(double)]{}; //Worst case size
-#ifdef ARDUINO
-		return handle_insert(length(),
-			dtostrf(f, static_cast<int8_t>(width), static_cast<uint8_t>(prec), buf), false);
-#else
-		//We alloc safe size for format buffer 
-		char_type fmt[24]{};
-		snprintf(fmt, sizeof(fmt) - 1, "%%%d.%df", width, prec);
-		snprintf(buf, sizeof(buf) - 1, fmt, f);
-		return handle_insert(length(), buf, false);
+		const auto start = length();
+		if (!concat_arg(arg, f))
+			return false;
+		const auto arg_len = length() - start;
+		if (arg_len >= f.width)
+			return true;
+		//Pad to width, clipped at capacity()
+		const auto pad = f.width - arg_len;
+		const bool left_align = FixedStringArg<Arg>::kind == arg_text || FixedStringArg<Arg>::kind == arg_char || FixedStringArg<Arg>::kind == arg_bool;
+		if (left_align)
+		{
+			const auto spaces = get_min(pad, available());
+			FixedStringKernels::fill(end(), ' ', spaces);
+			return set_len(length() + spaces, spaces == pad);
+		}
+		const auto room = capacity() - start;
+		const auto spaces = get_min(pad, room);
+		const auto arg_cnt = get_min(arg_len, room - spaces);
+		FixedStringKernels::move(begin() + start + spaces, begin() + start, arg_cnt);
+		FixedStringKernels::fill(begin() + start, ' ', spaces);
+		return set_len(start + spaces + arg_cnt, spaces + arg_cnt == pad + arg_len);
+	}
+	static Radix field_radix(const FixedStringField& f)
+	{
+		return f.type == 'x' ? base16 : f.type == 'o' ? base8 : f.type == 'b' ? base2 : base10;
+	}
+	bool concat_arg(char c, const FixedStringField&) { return concat(c); }
+	bool concat_arg(bool b, const FixedStringField&) { return concat(b ? "true" : "false"); }
+	bool concat_arg(signed char i, const FixedStringField& f) { return append_number(static_cast<int>(i), field_radix(f), true); }
+	bool concat_arg(short i, const FixedStringField& f) { return append_number(static_cast<int>(i), field_radix(f), true); }
+	bool concat_arg(unsigned short u, const FixedStringField& f) { return append_number(static_cast<unsigned int>(u), field_radix(f), true); }
+	bool concat_arg(unsigned char u, const FixedStringField& f) { return append_number(u, field_radix(f), true); }
+	bool concat_arg(int i, const FixedStringField& f) { return append_number(i, field_radix(f), true); }
+	bool concat_arg(unsigned int u, const FixedStringField& f) { return append_number(u, field_radix(f), true); }
+	bool concat_arg(long i, const FixedStringField& f) { return append_number(i, field_radix(f), true); }
+	bool concat_arg(unsigned long u, const FixedStringField& f) { return append_number(u, field_radix(f), true); }
+#ifndef ARDUINO
+	bool concat_arg(long long i, const FixedStringField& f) { return append_number(i, field_radix(f), true); }
+	bool concat_arg(unsigned long long u, const FixedStringField& f) { return append_number(u, field_radix(f), true); }
 #endif
+	bool concat_arg(double d, const FixedStringField& f)
+	{
+		return append_float(d, 0, f.prec == FixedStringField::c_default_prec ? 2 : f.prec, true);
 	}
-	bool notify_overrun()
+	bool concat_arg(const_pointer str, const FixedStringField&) { return concat(str); }
+	bool concat_arg(FixedStringView v, const FixedStringField&) { return concat(v); }
+	template<size_type c_storage_size2, typename OverrunPolicy2>
+	bool concat_arg(const FixedString<c_storage_size2, OverrunPolicy2>& rhs, const FixedStringField&) { return concat(rhs); }
+#ifdef ARDUINO
+	bool concat_arg(const String& s, const FixedStringField&) { return concat(s); }
+#endif
+	//The truncated string, or the text that could not be added
+	FIXEDSTRING_CONSTEXPR bool notify_overrun()
 	{
-		printf("Fixed string : '%s' has overrun\n", c_str());
+		profile_overrun();
+		OverrunPolicy::overrun(c_str(), length());
 		return false;
 	}
-	bool notify_overrun(const_pointer data, size_type len)
+	FIXEDSTRING_CONSTEXPR bool notify_overrun(const_pointer data, size_type len)
 	{
-		printf("Fixed string too small cannot add: '%.*s'\n", len, data);
+		profile_overrun();
+		OverrunPolicy::overrun(data, len);
 		return false;
 	}
+	//FIXEDSTRING_PROFILE: counted by storage size, not at compile time
+	FIXEDSTRING_CONSTEXPR void profile_len(size_type len)
+	{
+#if defined(FIXEDSTRING_PROFILE) && !defined(ARDUINO)
+		if (len != 0 && !FixedStringKernels::in_constant_evaluation())
+			FixedStringProfile::stats<c_storage_size>(capacity()).set_len(len);
+#else
+		(void)len;
+#endif
+	}
+	FIXEDSTRING_CONSTEXPR void profile_overrun()
+	{
+#if defined(FIXEDSTRING_PROFILE) && !defined(ARDUINO)
+		if (!FixedStringKernels::in_constant_evaluation())
+			FixedStringProfile::stats<c_storage_size>(capacity()).truncated();
+#endif
+	}
 public:
 #ifdef ARDUINO
 	friend FixedString operator+(const String& s, const FixedString& rhs) { return FixedString(s) += rhs; }
 	friend FixedString operator+(FlashPtr s, const FixedString& rhs) { return FixedString(s) += rhs; }
+	friend FixedString operator+(const FixedString& lhs, const String& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(const FixedString& lhs, FlashPtr rhs) { return FixedString(lhs) += rhs; }
+#endif
+	//Numbers are formatted into a FixedString first, text gives a FixedStringConcat (below)
+	friend FixedString operator+(int lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(unsigned int lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(long lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(unsigned long lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+#ifndef ARDUINO
+	friend FixedString operator+(long long lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(unsigned long long lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
 #endif
-	friend FixedString operator+(const_pointer s, const FixedString& rhs) { return FixedString(s) += rhs; }
-	template<typename TRhs> //All others
-	friend FixedString operator+(TRhs lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(float lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	friend FixedString operator+(double lhs, const FixedString& rhs) { return FixedString(lhs) += rhs; }
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// operator+ for text, see FixedStringConcat
+// The result is limited to the right hand FixedString's capacity, or the left hand one's
+// when the right is a view, const char* or char - as appending to a copy of it would be.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<typename TString, unsigned int c_lhs, typename TLhs, unsigned int c_rhs, typename TRhs>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_lhs + c_rhs, TString> fixedstring_join(const FixedStringConcat<c_lhs, TLhs>& lhs, const FixedStringConcat<c_rhs, TRhs>& rhs)
+{
+	return FixedStringConcat<c_lhs + c_rhs, TString>(lhs, rhs);
+}
+//Single operands, a FixedString is never NULL (nor, at compile time, compared to it)
+template<typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<1, TString> fixedstring_part(FixedStringView v) { return FixedStringConcat<1, TString>(v.data(), v.length()); }
+template<typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<1, TString> fixedstring_part(char c) { return FixedStringConcat<1, TString>(c); }
+template<typename TString, unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<1, TString> fixedstring_part(const FixedString<c_storage_size, OverrunPolicy>& s) { return FixedStringConcat<1, TString>(s.c_str(), s.length()); }
+
+template<unsigned int c_lhs_size, typename TLhsPolicy, unsigned int c_rhs_size, typename TRhsPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<2, FixedString<c_rhs_size, TRhsPolicy> > operator+(const FixedString<c_lhs_size, TLhsPolicy>& lhs, const FixedString<c_rhs_size, TRhsPolicy>& rhs)
+{
+	typedef FixedString<c_rhs_size, TRhsPolicy> TString;
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<2, FixedString<c_storage_size, OverrunPolicy> > operator+(const FixedString<c_storage_size, OverrunPolicy>& lhs, FixedStringView rhs)
+{
+	typedef FixedString<c_storage_size, OverrunPolicy> TString;
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<2, FixedString<c_storage_size, OverrunPolicy> > operator+(const FixedString<c_storage_size, OverrunPolicy>& lhs, char rhs)
+{
+	typedef FixedString<c_storage_size, OverrunPolicy> TString;
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<2, FixedString<c_storage_size, OverrunPolicy> > operator+(FixedStringView lhs, const FixedString<c_storage_size, OverrunPolicy>& rhs)
+{
+	typedef FixedString<c_storage_size, OverrunPolicy> TString;
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<2, FixedString<c_storage_size, OverrunPolicy> > operator+(char lhs, const FixedString<c_storage_size, OverrunPolicy>& rhs)
+{
+	typedef FixedString<c_storage_size, OverrunPolicy> TString;
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), fixedstring_part<TString>(rhs));
+}
+//Extending an expression
+template<unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, TString> operator+(const FixedStringConcat<c_parts, TString>& lhs, FixedStringView rhs)
+{
+	return fixedstring_join<TString>(lhs, fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, TString> operator+(const FixedStringConcat<c_parts, TString>& lhs, char rhs)
+{
+	return fixedstring_join<TString>(lhs, fixedstring_part<TString>(rhs));
+}
+template<unsigned int c_parts, typename TString, unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, FixedString<c_storage_size, OverrunPolicy> > operator+(const FixedStringConcat<c_parts, TString>& lhs, const FixedString<c_storage_size, OverrunPolicy>& rhs)
+{
+	typedef FixedString<c_storage_size, OverrunPolicy> TRhsString;
+	return fixedstring_join<TRhsString>(lhs, fixedstring_part<TRhsString>(rhs));
+}
+template<unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, TString> operator+(FixedStringView lhs, const FixedStringConcat<c_parts, TString>& rhs)
+{
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), rhs);
+}
+template<unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, TString> operator+(char lhs, const FixedStringConcat<c_parts, TString>& rhs)
+{
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), rhs);
+}
+template<unsigned int c_storage_size, typename OverrunPolicy, unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_parts + 1, TString> operator+(const FixedString<c_storage_size, OverrunPolicy>& lhs, const FixedStringConcat<c_parts, TString>& rhs)
+{
+	return fixedstring_join<TString>(fixedstring_part<TString>(lhs), rhs);
+}
+template<unsigned int c_lhs, typename TLhs, unsigned int c_rhs, typename TRhs>
+FIXEDSTRING_CONSTEXPR FixedStringConcat<c_lhs + c_rhs, TRhs> operator+(const FixedStringConcat<c_lhs, TLhs>& lhs, const FixedStringConcat<c_rhs, TRhs>& rhs)
+{
+	return fixedstring_join<TRhs>(lhs, rhs);
+}
+//A FixedString temporary is added to at once, as an expression kept in an auto would outlive
+//it - same result and limits. Not after a char, which would clash with int + FixedString.
+template<typename TString, typename TLhs, typename TRhs>
+FIXEDSTRING_CONSTEXPR TString fixedstring_add(const TLhs& lhs, const TRhs& rhs)
+{
+	TString result(lhs);
+	result += rhs;
+	return result;
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_storage_size, OverrunPolicy> operator+(FixedString<c_storage_size, OverrunPolicy>&& lhs, FixedStringView rhs)
+{
+	return fixedstring_add<FixedString<c_storage_size, OverrunPolicy> >(lhs, rhs);
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_storage_size, OverrunPolicy> operator+(FixedString<c_storage_size, OverrunPolicy>&& lhs, char rhs)
+{
+	return fixedstring_add<FixedString<c_storage_size, OverrunPolicy> >(lhs, rhs);
+}
+template<unsigned int c_lhs_size, typename TLhsPolicy, unsigned int c_rhs_size, typename TRhsPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_rhs_size, TRhsPolicy> operator+(FixedString<c_lhs_size, TLhsPolicy>&& lhs, const FixedString<c_rhs_size, TRhsPolicy>& rhs)
+{
+	return fixedstring_add<FixedString<c_rhs_size, TRhsPolicy> >(lhs, rhs);
+}
+template<unsigned int c_lhs_size, typename TLhsPolicy, unsigned int c_rhs_size, typename TRhsPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_rhs_size, TRhsPolicy> operator+(const FixedString<c_lhs_size, TLhsPolicy>& lhs, FixedString<c_rhs_size, TRhsPolicy>&& rhs)
+{
+	return fixedstring_add<FixedString<c_rhs_size, TRhsPolicy> >(lhs, rhs);
+}
+template<unsigned int c_lhs_size, typename TLhsPolicy, unsigned int c_rhs_size, typename TRhsPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_rhs_size, TRhsPolicy> operator+(FixedString<c_lhs_size, TLhsPolicy>&& lhs, FixedString<c_rhs_size, TRhsPolicy>&& rhs)
+{
+	return fixedstring_add<FixedString<c_rhs_size, TRhsPolicy> >(lhs, rhs);
+}
+template<unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_storage_size, OverrunPolicy> operator+(FixedStringView lhs, FixedString<c_storage_size, OverrunPolicy>&& rhs)
+{
+	return fixedstring_add<FixedString<c_storage_size, OverrunPolicy> >(lhs, rhs);
+}
+template<unsigned int c_parts, typename TString, unsigned int c_storage_size, typename OverrunPolicy>
+FIXEDSTRING_CONSTEXPR FixedString<c_storage_size, OverrunPolicy> operator+(const FixedStringConcat<c_parts, TString>& lhs, FixedString<c_storage_size, OverrunPolicy>&& rhs)
+{
+	return fixedstring_add<FixedString<c_storage_size, OverrunPolicy> >(lhs, rhs);
+}
+template<unsigned int c_storage_size, typename OverrunPolicy, unsigned int c_parts, typename TString>
+FIXEDSTRING_CONSTEXPR TString operator+(FixedString<c_storage_size, OverrunPolicy>&& lhs, const FixedStringConcat<c_parts, TString>& rhs)
+{
+	return fixedstring_add<TString>(lhs, rhs);
+}
+
+#ifndef ARDUINO
+///////////////////////////////////////////////////////////////////////////////////////////
+// Hashing
+// std::hash<FixedString<N>> plus a transparent hash & equality so containers keyed by
+// FixedString can be searched with a const char* or std::string_view without building a key:
+//		std::unordered_map<FixedString<16>, int, FixedStringHash, FixedStringEqual> m;
+//		m.find("AAPL");//Heterogeneous lookup needs C++20 for unordered containers
+// All give the same hash for the same text. See also FixedStringMap.h
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace std
+{
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	struct hash<FixedString<c_storage_size, OverrunPolicy> >
+	{
+		size_t operator()(const FixedString<c_storage_size, OverrunPolicy>& s)const { return s.hash(); }
 	};
+}
+
+struct FixedStringHash
+{
+	using is_transparent = void;
+	size_t operator()(std::string_view s)const { return FixedStringKernels::hash(s.data(), s.size()); }
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_t operator()(const FixedString<c_storage_size, OverrunPolicy>& s)const { return s.hash(); }
+};
+
+struct FixedStringEqual
+{
+	using is_transparent = void;
+	template<typename TLhs, typename TRhs>
+	bool operator()(const TLhs& lhs, const TRhs& rhs)const { return view(lhs) == view(rhs); }
+private:
+	static std::string_view view(std::string_view s) { return s; }
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	static std::string_view view(const FixedString<c_storage_size, OverrunPolicy>& s) { return std::string_view(s.c_str(), s.length()); }
+};
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 #endif
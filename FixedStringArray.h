@@ -0,0 +1,277 @@
+// Fixed String - columnar array of fixed width strings
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGARRAY_H
+#define _FIXEDSTRINGARRAY_H
+#pragma once
+#include "FixedString.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringArray
+// Up to c_rows strings of at most c_width chars, held in the object itself as two columns:
+//	the chars, one zero padded c_width byte row per string, and the lengths.
+//		static FixedStringArray<32, 500000> symbols;
+//		symbols.push_back("AAPL.O");
+//		FixedStringArray<32, 500000>::Selection hits;
+//		symbols.startsWith("AAPL", hits);
+//
+// The bulk queries (equals, startsWith, endsWith, contains) run over the whole column: the
+// length column is compared 16/32 lengths at a time to rule most rows out first, then only
+// the candidate rows are compared, a 16/32 byte block at a time. indexOf gives a result for
+// every row so checks each one. Rows are contiguous so a scan streams through memory.
+// Query results go in a Selection (one bit per row) which can be combined with & and |.
+// Strings longer than c_width are rejected, never truncated.
+// Row views (operator[]) are valid until that row is changed.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_width, unsigned int c_rows>
+class FixedStringArray
+{
+	static_assert(c_width > 0 && c_rows > 0, "FixedStringArray needs a width and rows");
+public:
+	using size_type = unsigned int;
+	using char_type = char;
+	using const_pointer = const char*;
+	using length_type = typename FixedStringLength<c_width + 1ul>::type;
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Selection - one bit per row
+	///////////////////////////////////////////////////////////////////////////////////////
+	class Selection
+	{
+		friend class FixedStringArray;
+		static constexpr size_type c_words = (c_rows + 31) / 32;
+		uint32_t m_bits[c_words];
+	public:
+		Selection() :m_bits() {}
+
+		bool test(size_type row)const { return row < c_rows && (m_bits[row / 32] >> (row % 32) & 1u) != 0; }
+		bool operator[](size_type row)const { return test(row); }
+		void set(size_type row, bool value = true)
+		{
+			if (row >= c_rows)
+				return;
+			if (value)
+				m_bits[row / 32] |= static_cast<uint32_t>(1) << (row % 32);
+			else
+				m_bits[row / 32] &= ~(static_cast<uint32_t>(1) << (row % 32));
+		}
+		void clear()
+		{
+			for (size_type i = 0; i < c_words; i++)
+				m_bits[i] = 0;
+		}
+		size_type count()const
+		{
+			size_type n = 0;
+			for (size_type i = 0; i < c_words; i++)
+				n += static_cast<size_type>(__builtin_popcountl(m_bits[i]));
+			return n;
+		}
+		bool any()const
+		{
+			for (size_type i = 0; i < c_words; i++)
+				if (m_bits[i] != 0)
+					return true;
+			return false;
+		}
+		Selection& operator&=(const Selection& rhs)
+		{
+			for (size_type i = 0; i < c_words; i++)
+				m_bits[i] &= rhs.m_bits[i];
+			return *this;
+		}
+		Selection& operator|=(const Selection& rhs)
+		{
+			for (size_type i = 0; i < c_words; i++)
+				m_bits[i] |= rhs.m_bits[i];
+			return *this;
+		}
+		//fn(size_type row) for every selected row, in row order
+		template<typename Fn>
+		void for_each(Fn fn)const
+		{
+			for (size_type i = 0; i < c_words; i++)
+			{
+				for (uint32_t bits = m_bits[i]; bits != 0; bits &= bits - 1)
+					fn(i * 32 + FixedStringKernels::lowest_bit(bits));
+			}
+		}
+	};
+
+private:
+	char m_chars[c_rows * c_width];
+	length_type m_lens[c_rows];
+	size_type m_size;
+public:
+	//Rows are only written as they are added so a large static array costs nothing until used
+	FixedStringArray() :m_size(0) {}
+
+	static constexpr size_type capacity() { return c_rows; }
+	static constexpr size_type width() { return c_width; }
+	size_type size()const { return m_size; }
+	bool empty()const { return m_size == 0; }
+	bool full()const { return m_size >= c_rows; }
+	void clear() { m_size = 0; }
+
+	//Returns false if full or s is longer than width()
+	bool push_back(FixedStringView s)
+	{
+		if (full() || s.length() > c_width)
+			return false;
+		store(m_size++, s);
+		return true;
+	}
+	void pop_back()
+	{
+		if (m_size > 0)
+			m_size--;
+	}
+	//Returns false if row >= size() or s is longer than width()
+	bool set(size_type row, FixedStringView s)
+	{
+		if (row >= m_size || s.length() > c_width)
+			return false;
+		store(row, s);
+		return true;
+	}
+
+	//Row access - valid until the row is changed
+	FixedStringView operator[](size_type row)const { return FixedStringView(row_data(row), m_lens[row]); }
+	FixedStringView at(size_type row)const { return row < m_size ? (*this)[row] : FixedStringView(); }
+	size_type length(size_type row)const { return row < m_size ? m_lens[row] : 0; }
+
+	//First row equal to s, -1 if none
+	int find(FixedStringView s)const
+	{
+		if (s.length() > c_width)
+			return -1;
+		char padded[c_width];
+		pad(padded, s);
+		for (size_type row = 0; row < m_size; row++)
+		{
+			if (m_lens[row] == s.length() && FixedStringKernels::equal_prefix_block(row_data(row), padded, s.length(), c_width))
+				return static_cast<int>(row);
+		}
+		return -1;
+	}
+
+	//Bulk queries - out is set to the matching rows
+	void equals(FixedStringView s, Selection& out)const
+	{
+		if (s.length() > c_width)
+		{
+			out.clear();
+			return;
+		}
+		char padded[c_width];
+		pad(padded, s);
+		const size_type len = s.length();
+		select(out, len, false, [&](size_type row) {
+			return FixedStringKernels::equal_prefix_block(row_data(row), padded, len, c_width);
+		});
+	}
+	void startsWith(FixedStringView s, Selection& out)const
+	{
+		if (s.length() > c_width)
+		{
+			out.clear();
+			return;
+		}
+		char padded[c_width];
+		pad(padded, s);
+		const size_type len = s.length();
+		select(out, len, true, [&](size_type row) {
+			return FixedStringKernels::equal_prefix_block(row_data(row), padded, len, c_width);
+		});
+	}
+	void endsWith(FixedStringView s, Selection& out)const
+	{
+		if (s.length() > c_width)
+		{
+			out.clear();
+			return;
+		}
+		const size_type len = s.length();
+		select(out, len, true, [&](size_type row) {
+			return FixedStringKernels::compare(row_data(row) + m_lens[row] - len, s.data(), len) == 0;
+		});
+	}
+	void contains(FixedStringView s, Selection& out)const
+	{
+		if (s.length() > c_width)
+		{
+			out.clear();
+			return;
+		}
+		select(out, s.length(), true, [&](size_type row) { return (*this)[row].indexOf(s) >= 0; });
+	}
+	void contains(char_type c, Selection& out)const
+	{
+		select(out, 1, true, [&](size_type row) { return FixedStringKernels::find_char(row_data(row), m_lens[row], c) != NULL; });
+	}
+
+	//Per row index of the first s or c (-1 if none), out must have size() entries
+	void indexOf(FixedStringView s, int* out)const
+	{
+		for (size_type row = 0; row < m_size; row++)
+			out[row] = (*this)[row].indexOf(s);
+	}
+	void indexOf(char_type c, int* out)const
+	{
+		for (size_type row = 0; row < m_size; row++)
+			out[row] = (*this)[row].indexOf(c);
+	}
+private:
+	const_pointer row_data(size_type row)const { return m_chars + static_cast<size_t>(row) * c_width; }
+	//The bytes after the string are zeroed so a row can always be read as a whole block
+	void store(size_type row, FixedStringView s)
+	{
+		char* dest = m_chars + static_cast<size_t>(row) * c_width;
+		memcpy(dest, s.data(), s.length());
+		memset(dest + s.length(), 0, c_width - s.length());
+		m_lens[row] = static_cast<length_type>(s.length());
+	}
+	static void pad(char* padded, FixedStringView s)
+	{
+		memcpy(padded, s.data(), s.length());
+		memset(padded + s.length(), 0, c_width - s.length());
+	}
+	//Rows are tested 32 at a time into one word of out: the length column gives the candidates
+	//(length == len, or >= len if at_least) a block at a time and only those go to pred
+	template<typename Pred>
+	void select(Selection& out, size_type len, bool at_least, Pred pred)const
+	{
+		size_type word = 0;
+		for (size_type row = 0; row < m_size; row += 32, word++)
+		{
+			const size_type n = m_size - row < 32 ? m_size - row : 32;
+			uint32_t bits = 0;
+			for (uint32_t candidates = FixedStringKernels::rt::length_mask(m_lens + row, n, len, at_least); candidates != 0; candidates &= candidates - 1)
+			{
+				const unsigned bit = FixedStringKernels::lowest_bit(candidates);
+				if (pred(row + bit))
+					bits |= static_cast<uint32_t>(1) << bit;
+			}
+			out.m_bits[word] = bits;
+		}
+		for (; word < Selection::c_words; word++)
+			out.m_bits[word] = 0;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,596 @@
+// Fixed String - inline string that spills to a caller supplied arena
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGHYBRID_H
+#define _FIXEDSTRINGHYBRID_H
+#pragma once
+#include "FixedString.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringArena
+// Bump allocator over a caller supplied buffer - allocation is a pointer increment, there is
+// no free, reset() gives back everything at once (e.g. at the end of each request):
+//		static char buffer[4096];
+//		FixedStringArena arena(buffer, sizeof(buffer));
+//		...
+//		arena.reset();
+// The last allocation can be grown in place with extend(). Never calls new or malloc.
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringArena
+{
+public:
+	using size_type = size_t;
+private:
+	char* m_buffer;
+	size_type m_size;
+	size_type m_used;
+	size_type m_last;	//Offset of the last allocation, so it can be extended
+	unsigned long m_failed;
+public:
+	FixedStringArena(void* buffer, size_type size) :m_buffer(static_cast<char*>(buffer)), m_size(buffer == NULL ? 0 : size), m_used(0), m_last(0), m_failed(0) {}
+	FixedStringArena(const FixedStringArena&) = delete;
+	FixedStringArena& operator=(const FixedStringArena&) = delete;
+
+	//NULL if there is not n bytes left
+	void* allocate(size_type n)
+	{
+		if (n > m_size - m_used)
+		{
+			m_failed++;
+			return NULL;
+		}
+		m_last = m_used;
+		m_used += n;
+		return m_buffer + m_last;
+	}
+	//Grows p (of size bytes) to new_size if it is the last allocation and there is room
+	bool extend(void* p, size_type size, size_type new_size)
+	{
+		if (p != m_buffer + m_last || m_last + size != m_used || new_size > m_size - m_last)
+			return false;
+		m_used = m_last + new_size;
+		return true;
+	}
+	//Everything allocated is given back, strings that spilled into the arena must not be used after
+	void reset() { m_used = m_last = 0; }
+
+	size_type capacity()const { return m_size; }
+	size_type used()const { return m_used; }
+	size_type available()const { return m_size - m_used; }
+	//Allocations refused for lack of space, not cleared by reset()
+	unsigned long failed()const { return m_failed; }
+};
+
+//An arena holding its own c_size byte buffer
+template<unsigned int c_size>
+class FixedStringArenaBuffer : public FixedStringArena
+{
+	char m_storage[c_size];
+public:
+	FixedStringArenaBuffer() :FixedStringArena(m_storage, c_size) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringHybrid
+// A string sized for the common case that still holds the rare long value: the first
+// c_inline_size - 1 chars are held inline, a longer string spills to a FixedStringArena
+// rather than being truncated:
+//		FixedStringArenaBuffer<8192> arena;
+//		FixedStringHybrid<32> name(&arena);
+//		name = header.value;	//Up to 31 chars inline, longer is copied to the arena
+//		...
+//		arena.reset();			//Per request, once the strings are finished with
+//
+// The API is FixedString's (assign, concat, +=, insert, replace, search, compare...) and it
+// converts to a FixedStringView. On spilling the capacity at least doubles, growing in place
+// when the string is the arena's last allocation. Only when there is no arena, or it is full,
+// is the string truncated and the overrun policy told, as FixedString.
+// A spilled string is only valid until its arena is reset(). Copies spill to the same arena,
+// moves take over the spilled text when both use the same arena (else they copy, as it is the
+// string's arena that says how long its text lives). Never calls new or malloc.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_inline_size = 32, typename OverrunPolicy = FIXEDSTRING_OVERRUN_POLICY>
+class FixedStringHybrid
+{
+	static_assert(c_inline_size >= 2, "FixedStringHybrid needs room for a char and the null");
+public:
+	using size_type = unsigned int;
+	using char_type = char;
+	using pointer = char*;
+	using const_pointer = const char*;
+	static constexpr size_type npos = static_cast<size_type>(-1);
+private:
+	pointer m_str;	//m_inline or a block in m_arena
+	size_type m_len;
+	size_type m_capacity;
+	FixedStringArena* m_arena;
+	char_type m_inline[c_inline_size];
+public:
+	explicit FixedStringHybrid(FixedStringArena* arena = NULL) { init(arena); }
+	FixedStringHybrid(const_pointer str, FixedStringArena* arena = NULL) { init(arena); assign(str); }
+	FixedStringHybrid(const_pointer data, size_type len, FixedStringArena* arena = NULL) { init(arena); assign(data, len); }
+	FixedStringHybrid(FixedStringView v, FixedStringArena* arena = NULL) { init(arena); assign(v); }
+	FixedStringHybrid(const FixedStringHybrid& rhs) { init(rhs.m_arena); assign(rhs.view()); }
+	FixedStringHybrid(FixedStringHybrid&& rhs) { init(rhs.m_arena); take(rhs); }
+	template<unsigned int c_parts, typename TString>
+	FixedStringHybrid(const FixedStringConcat<c_parts, TString>& expr, FixedStringArena* arena = NULL) { init(arena); concat(expr); }
+
+	FixedStringHybrid& operator=(const FixedStringHybrid& rhs) { assign(rhs.view()); return *this; }
+	FixedStringHybrid& operator=(FixedStringHybrid&& rhs)
+	{
+		if (&rhs != this)
+			take(rhs);
+		return *this;
+	}
+	FixedStringHybrid& operator=(const_pointer str) { assign(str); return *this; }
+	FixedStringHybrid& operator=(FixedStringView v) { assign(v); return *this; }
+	FixedStringHybrid& operator=(char_type c) { assign(1, c); return *this; }
+	template<unsigned int c_parts, typename TString>
+	FixedStringHybrid& operator=(const FixedStringConcat<c_parts, TString>& expr) { assign(expr); return *this; }
+
+	//Size
+	static constexpr size_type inline_capacity() { return c_inline_size - 1; }
+	size_type length()const { return m_len; }
+	//Chars that fit without spilling (further)
+	size_type capacity()const { return m_capacity; }
+	size_type available()const { return m_capacity - m_len; }
+	bool empty()const { return m_len == 0; }
+	bool spilled()const { return m_str != m_inline; }
+	FixedStringArena* arena()const { return m_arena; }
+	//Makes room for len chars, false if it would not fit
+	bool reserve(size_type len)
+	{
+		if (len <= m_capacity)
+			return true;
+		if (m_arena == NULL || len == npos)
+			return false;
+		const size_type doubled = m_capacity > npos / 2 - 1 ? npos - 1 : m_capacity * 2 + 1;
+		const size_type wanted = len > doubled ? len : doubled;
+		if (spilled())
+		{
+			if (m_arena->extend(m_str, m_capacity + 1u, wanted + 1u))
+				return grown(wanted);
+			if (m_arena->extend(m_str, m_capacity + 1u, len + 1u))
+				return grown(len);
+		}
+		size_type new_capacity = wanted;
+		void* block = m_arena->allocate(wanted + 1u);
+		if (block == NULL)
+		{
+			new_capacity = len;
+			block = m_arena->allocate(len + 1u);
+		}
+		if (block == NULL)
+			return false;
+		memcpy(block, m_str, m_len + 1u);
+		m_str = static_cast<pointer>(block);
+		return grown(new_capacity);
+	}
+
+	//assign - false if the result was truncated
+	void clear() { set_len(0); }
+	bool assign(const_pointer data, size_type len)
+	{
+		if (data == NULL)
+			len = 0;
+		//The text may be part of this string, it is still readable after a spill
+		const bool fits = reserve(len);
+		const size_type actual_cnt = fits ? len : m_capacity;
+		FixedStringKernels::move(m_str, data, actual_cnt);
+		return set_len(actual_cnt, fits);
+	}
+	bool assign(const_pointer str) { return assign(str, safe_len(str)); }
+	bool assign(FixedStringView v) { return assign(v.data(), v.length()); }
+	bool assign(size_type repeat, char_type c) { clear(); return concat(repeat, c); }
+	template<unsigned int c_parts, typename TString>
+	bool assign(const FixedStringConcat<c_parts, TString>& expr)
+	{
+		if (!expr.refers_to(m_str, m_len))
+		{
+			clear();
+			return concat(expr);
+		}
+		//e.g. s = "x" + s, the parts are read from this string so build it aside
+		FixedStringHybrid temp(m_arena);
+		const bool ok = temp.concat(expr);
+		return assign(temp.view()) && ok;
+	}
+	bool assign(int i, Radix r = base10) { clear(); return concat(i, r); }
+	bool assign(unsigned int u, Radix r = base10) { clear(); return concat(u, r); }
+	bool assign(long l, Radix r = base10) { clear(); return concat(l, r); }
+	bool assign(unsigned long u, Radix r = base10) { clear(); return concat(u, r); }
+#ifndef ARDUINO
+	bool assign(long long l, Radix r = base10) { clear(); return concat(l, r); }
+	bool assign(unsigned long long u, Radix r = base10) { clear(); return concat(u, r); }
+#endif
+	bool assign(float f, size_type decPlaces = 2) { clear(); return concat(f, decPlaces); }
+	bool assign(double d, size_type decPlaces = 2) { clear(); return concat(d, decPlaces); }
+
+	//concat - false if the result was truncated
+	bool concat(const_pointer data, size_type len) { return handle_insert(m_len, data, len); }
+	bool concat(const_pointer str) { return handle_insert(m_len, str, safe_len(str)); }
+	bool concat(FixedStringView v) { return handle_insert(m_len, v.data(), v.length()); }
+	bool concat(char_type c) { return handle_insert(m_len, 1, c); }
+	bool concat(size_type repeat, char_type c) { return handle_insert(m_len, repeat, c); }
+	//One spill for the whole expression, not one per part
+	template<unsigned int c_parts, typename TString>
+	bool concat(const FixedStringConcat<c_parts, TString>& expr)
+	{
+		const size_type len = expr.length();
+		const size_type actual_cnt = reserve(m_len + len) ? len : available();
+		expr.copy_to(m_str + m_len, actual_cnt);
+		return set_len(m_len + actual_cnt, actual_cnt == len && !expr.truncated());
+	}
+	//Numbers are formatted as FixedString then appended
+	bool concat(int i, Radix r = base10) { return concat_number(i, r); }
+	bool concat(unsigned int u, Radix r = base10) { return concat_number(u, r); }
+	bool concat(long l, Radix r = base10) { return concat_number(l, r); }
+	bool concat(unsigned long u, Radix r = base10) { return concat_number(u, r); }
+#ifndef ARDUINO
+	bool concat(long long l, Radix r = base10) { return concat_number(l, r); }
+	bool concat(unsigned long long u, Radix r = base10) { return concat_number(u, r); }
+#endif
+	bool concat(float f, size_type decPlaces = 2)
+	{
+		FixedString<c_number_size, OverrunPolicy> num(f, decPlaces);
+		return concat(num.view());
+	}
+	bool concat(double d, size_type decPlaces = 2)
+	{
+		FixedString<c_number_size, OverrunPolicy> num(d, decPlaces);
+		return concat(num.view());
+	}
+	template<typename Param>
+	FixedStringHybrid& operator+=(Param p) { concat(p); return *this; }
+	FixedStringHybrid& operator+=(const FixedStringHybrid& s) { concat(s.view()); return *this; }
+
+	//Edit - insert() is false if truncated (or index is past the end)
+	bool insert(size_type index, const_pointer str) { return handle_insert(index, str, safe_len(str)); }
+	bool insert(size_type index, const_pointer data, size_type len) { return handle_insert(index, data, len); }
+	bool insert(size_type index, FixedStringView v) { return handle_insert(index, v.data(), v.length()); }
+	bool insert(size_type index, size_type repeat, char_type c) { return handle_insert(index, repeat, c); }
+	void remove(size_type index) { if (index < m_len) set_len(index); }
+	void remove(size_type index, size_type cnt)
+	{
+		if (cnt == 0 || index >= m_len)
+			return;
+		const size_type actual_cnt = cnt < m_len - index ? cnt : m_len - index;
+		memmove(m_str + index, m_str + index + actual_cnt, m_len - index - actual_cnt + 1u);//shift rem chars down (including null char)
+		m_len -= actual_cnt;
+	}
+	void setCharAt(size_type index, char_type c)
+	{
+		if (index >= m_len)
+			return;
+		m_str[index] = c;
+		if (c == '\0')
+			set_len(index);//shrink
+	}
+	void replace(char_type c, char_type new_c)
+	{
+		if (c == 0 || new_c == 0 || c == new_c)
+			return;
+		for (char_type& p : *this)
+		{
+			if (p == c)
+				p = new_c;
+		}
+	}
+	//Returns false if the result was truncated
+	bool replace(FixedStringView s, FixedStringView new_s)
+	{
+		bool complete = true;
+		handle_replace_all(s, new_s, complete);
+		return complete;
+	}
+	//Returns the number of matches replaced
+	size_type replace_all(FixedStringView s, FixedStringView new_s)
+	{
+		bool complete = true;
+		return handle_replace_all(s, new_s, complete);
+	}
+	void toLowerCase() { FixedStringKernels::to_lower(m_str, m_len); }
+	void toUpperCase() { FixedStringKernels::to_upper(m_str, m_len); }
+	void trim()
+	{
+		FixedStringView text = view();
+		text.trim();
+		if (text.data() > m_str)
+			memmove(m_str, text.data(), text.length());
+		set_len(text.length());
+	}
+	void trim_left()
+	{
+		FixedStringView text = view();
+		text.trim_left();
+		if (text.data() > m_str)
+			memmove(m_str, text.data(), text.length());
+		set_len(text.length());
+	}
+	void trim_right()
+	{
+		FixedStringView text = view();
+		text.trim_right();
+		set_len(text.length());
+	}
+
+	//Data access - pointers and views are valid until the string is next modified
+	const_pointer c_str()const { return m_str; }
+	const_pointer begin()const { return m_str; }
+	const_pointer end()const { return m_str + m_len; }
+	pointer begin() { return m_str; }
+	pointer end() { return m_str + m_len; }
+	FixedStringView view()const { return FixedStringView(m_str, m_len); }
+	FixedStringView view(size_type left, size_type right = npos)const { return view().substring(left, right); }
+	operator FixedStringView()const { return view(); }
+#ifndef ARDUINO
+	explicit operator std::string_view()const { return std::string_view(m_str, m_len); }
+#endif
+	char_type charAt(size_type index)const { return index < m_len ? m_str[index] : 0; }
+	char_type operator[](size_type index)const { return charAt(index); }
+	//A copy in the same arena
+	FixedStringHybrid substring(size_type left, size_type right = npos)const { return FixedStringHybrid(view().substring(left, right), m_arena); }
+	FixedStringSplit split(char_type delim)const { return view().split(delim); }
+	FixedStringTokens tokenize(const_pointer delims)const { return view().tokenize(delims); }
+	size_t hash()const { return FixedStringKernels::hash(m_str, m_len); }
+
+	//Comparison
+	bool equals(FixedStringView rhs)const { return view().equals(rhs); }
+	bool equalsIgnoreCase(FixedStringView rhs)const { return view().equalsIgnoreCase(rhs); }
+	int compareTo(FixedStringView rhs)const { return view().compareTo(rhs); }
+	bool operator==(FixedStringView rhs)const { return equals(rhs); }
+	bool operator!=(FixedStringView rhs)const { return !equals(rhs); }
+	bool operator<(FixedStringView rhs)const { return compareTo(rhs) < 0; }
+	bool operator==(const_pointer rhs)const { return equals(rhs); }
+	bool operator!=(const_pointer rhs)const { return !equals(rhs); }
+	bool operator==(const FixedStringHybrid& rhs)const { return equals(rhs.view()); }
+	bool operator!=(const FixedStringHybrid& rhs)const { return !equals(rhs.view()); }
+	bool operator<(const FixedStringHybrid& rhs)const { return compareTo(rhs.view()) < 0; }
+
+	//Search
+	bool startsWith(FixedStringView s)const { return !s.empty() && view().startsWith(s); }
+	bool endsWith(FixedStringView s)const { return !s.empty() && view().endsWith(s); }
+	int indexOf(char_type c, size_type start_pos = 0)const { return view().indexOf(c, start_pos); }
+	int indexOf(FixedStringView s, size_type start_pos = 0)const { return view().indexOf(s, start_pos); }
+	int indexOf(const_pointer s, size_type start_pos = 0)const { return view().indexOf(FixedStringView(s), start_pos); }
+	int lastIndexOf(char_type c)const { return c == 0 ? -1 : view().lastIndexOf(c); }
+
+	//Numeric parsing, as FixedString
+	long	toInt()const { return to_int<long>(); }
+	float	toFloat()const { return to_float<float>(); }
+	double	toDouble()const { return to_float<double>(); }
+	template<typename T = double>
+	T to_float()const
+	{
+		T d = 0.0f;
+		get_float(d);
+		return d;
+	}
+	template<typename T = double>
+	bool get_float(T& d)const
+	{
+		d = 0.0f;
+		return get_number(d, base10) && !isnan(d);
+	}
+	template<typename T = int>
+	T to_int(Radix radix = base10)const
+	{
+		T i = 0;
+		get_int(i, radix);
+		return i;
+	}
+	template<typename T = int>
+	bool get_int(T& i, Radix radix = base10)const
+	{
+		i = 0;
+		return get_number(i, radix);
+	}
+	template<typename T>
+	FixedStringParse parse(T& value, Radix radix = base10)const { return view().parse(value, radix); }
+	template<typename T>
+	size_type parse_list(T* values, size_type max, char_type delim = ',', Radix radix = base10, FixedStringParse* result = NULL)const
+	{
+		return view().parse_list(values, max, delim, radix, result);
+	}
+private:
+	//Room for any integer in base 2 or a float
+	static constexpr size_type c_number_size = 80;
+
+	void init(FixedStringArena* arena)
+	{
+		m_str = m_inline;
+		m_len = 0;
+		m_capacity = inline_capacity();
+		m_arena = arena;
+		m_inline[0] = 0;
+	}
+	bool grown(size_type capacity)
+	{
+		m_capacity = capacity;
+		return true;
+	}
+	//A spilled string in the same arena is handed over, anything else is copied (into this
+	//string's arena) so the text never outlives the arena it is in
+	void take(FixedStringHybrid& rhs)
+	{
+		if (!rhs.spilled() || rhs.m_arena != m_arena)
+		{
+			assign(rhs.view());
+			return;
+		}
+		m_str = rhs.m_str;
+		m_len = rhs.m_len;
+		m_capacity = rhs.m_capacity;
+		rhs.m_str = rhs.m_inline;
+		rhs.m_capacity = inline_capacity();
+		rhs.set_len(0);
+	}
+	static size_type safe_len(const_pointer s) { return s == NULL ? 0 : static_cast<size_type>(FixedStringKernels::length(s)); }
+	void set_len(size_type len)
+	{
+		m_len = len;
+		m_str[len] = 0;
+	}
+	bool set_len(size_type len, bool append_ok)
+	{
+		set_len(len);
+		return append_ok || notify_overrun();
+	}
+	bool notify_overrun()
+	{
+		OverrunPolicy::overrun(m_str, m_len);
+		return false;
+	}
+	template<typename Num>
+	bool concat_number(Num n, Radix r)
+	{
+		FixedString<c_number_size, OverrunPolicy> num(n, r);
+		return concat(num.view());
+	}
+	template<typename T>
+	bool get_number(T& value, Radix radix)const
+	{
+		FixedStringView text = view();
+		text.trim();
+		if (!text.empty() && text[0] == '+')
+			text = text.substring(1);
+		const FixedStringParse res = text.parse(value, radix);
+		return res.ok() && res.pos == text.length();
+	}
+	//Spills rather than truncates, as FixedString when it cannot
+	bool handle_insert(size_type index, const_pointer data, size_type len)
+	{
+		if (index > m_len)
+			return false;
+		if (data == NULL || len == 0)
+			return true; //nothing to add
+		const size_type actual_cnt = reserve(len > npos - 1 - m_len ? npos - 1 : m_len + len) ? len : available();
+		if (actual_cnt == 0)
+		{
+			OverrunPolicy::overrun(data, len);
+			return false;
+		}
+		if (index < m_len)
+			memmove(m_str + index + actual_cnt, m_str + index, m_len - index);//shift rem chars up
+		FixedStringKernels::move(m_str + index, data, actual_cnt);
+		return set_len(m_len + actual_cnt, actual_cnt == len);
+	}
+	bool handle_insert(size_type index, size_type repeat, char_type c)
+	{
+		if (index > m_len)
+			return false;
+		if (repeat == 0 || c == '\0')
+			return true; //nothing to add
+		const size_type actual_cnt = reserve(repeat > npos - 1 - m_len ? npos - 1 : m_len + repeat) ? repeat : available();
+		if (actual_cnt == 0)
+			return notify_overrun();
+		if (index < m_len)
+			memmove(m_str + index + actual_cnt, m_str + index, m_len - index);//shift rem chars up
+		FixedStringKernels::fill(m_str + index, c, actual_cnt);
+		return set_len(m_len + actual_cnt, actual_cnt == repeat);
+	}
+	//Writes the first capacity() chars of a grown result backwards from final_len, as FixedString,
+	//dropping anything at or past capacity(). There is no room to mark the matches so they are
+	//found c_batch at a time, last first, each batch by a scan of the text not yet rewritten.
+	size_type replace_clipped(FixedStringView s, FixedStringView new_s, size_type count, size_type final_len)
+	{
+		static const size_type c_batch = 32;
+		size_type index[c_batch];
+		const size_type s_len = s.length();
+		const size_type new_len = new_s.length();
+		const size_type limit = final_len < m_capacity ? final_len : m_capacity;
+		size_type read = m_len;
+		size_type write = final_len;
+		for (size_type todo = count; todo > 0; )
+		{
+			const size_type first = todo > c_batch ? todo - c_batch : 0;
+			const_pointer p = m_str;
+			for (size_type i = 0; i < todo; i++, p += s_len)
+			{
+				//All the matches not yet rewritten are before read
+				p = FixedStringKernels::find_str(p, static_cast<size_type>(m_str + read - p), s.data(), s_len);
+				if (i >= first)
+					index[i - first] = static_cast<size_type>(p - m_str);
+			}
+			for (size_type i = todo - first; i-- > 0; )
+			{
+				const size_type tail_cnt = read - index[i] - s_len;
+				write -= tail_cnt;
+				copy_clipped(write, m_str + index[i] + s_len, tail_cnt, limit);
+				write -= new_len;
+				copy_clipped(write, new_s.data(), new_len, limit);
+				read = index[i];
+			}
+			todo = first;
+		}
+		return limit;
+	}
+	//Copy to dest_pos, dropping anything at or beyond limit
+	void copy_clipped(size_type dest_pos, const_pointer src, size_type cnt, size_type limit)
+	{
+		if (dest_pos < limit)
+			memmove(m_str + dest_pos, src, cnt < limit - dest_pos ? cnt : limit - dest_pos);
+	}
+	//One pass when the result fits (after spilling): the text is first moved to the end of
+	//the buffer by the growth, so writing from the start never overtakes the unread text.
+	//Otherwise it is cut at capacity() as FixedString, see replace_clipped().
+	size_type handle_replace_all(FixedStringView s, FixedStringView new_s, bool& complete)
+	{
+		const size_type s_len = s.length();
+		const size_type new_len = new_s.length();
+		if (s_len == 0 || s_len > m_len)
+			return 0;
+		size_type count = 0;
+		for (const_pointer p = m_str; static_cast<size_type>(end() - p) >= s_len; p += s_len, count++)
+		{
+			p = FixedStringKernels::find_str(p, static_cast<size_type>(end() - p), s.data(), s_len);
+			if (p == NULL)
+				break;
+		}
+		if (count == 0)
+			return 0;
+		const size_type final_len = m_len - count * s_len + count * new_len;
+		if (new_len > s_len && !reserve(final_len))
+		{
+			complete = set_len(replace_clipped(s, new_s, count, final_len), false);
+			return count;
+		}
+		const size_type shift = new_len > s_len ? m_capacity - m_len : 0;
+		if (shift > 0)
+			memmove(m_str + shift, m_str, m_len);
+		const_pointer read = m_str + shift;
+		const_pointer read_end = read + m_len;
+		pointer write = m_str;
+		for (;;)
+		{
+			const_pointer hit = static_cast<size_type>(read_end - read) >= s_len ? FixedStringKernels::find_str(read, static_cast<size_type>(read_end - read), s.data(), s_len) : NULL;
+			const_pointer stop = hit == NULL ? read_end : hit;
+			memmove(write, read, static_cast<size_t>(stop - read));
+			write += stop - read;
+			if (hit == NULL)
+				break;
+			memcpy(write, new_s.data(), new_len);
+			write += new_len;
+			read = hit + s_len;
+		}
+		set_len(final_len);
+		return count;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,1426 @@
+// Fixed String - low level string kernels
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGKERNELS_H
+#define _FIXEDSTRINGKERNELS_H
+#pragma once
+#ifdef ARDUINO
+#include "Arduino.h"
+#include <errno.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <charconv>
+#include <limits>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// SIMD selection
+// The kernels are selected at compile time from the target flags (e.g. -msse2, -mavx2).
+// x86-64 always has SSE2. Define FIXEDSTRING_NO_SIMD to force the portable scalar code.
+///////////////////////////////////////////////////////////////////////////////////////////
+#if !defined(ARDUINO) && !defined(FIXEDSTRING_NO_SIMD)
+#if defined(__AVX2__)
+#define FIXEDSTRING_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FIXEDSTRING_SSE2 1
+#endif
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// constexpr support
+// With C++20 most of FixedString is constexpr so literals, concatenations and comparisons
+// can be evaluated at compile time. Older standards (e.g. Arduino gnu++11) are unaffected.
+///////////////////////////////////////////////////////////////////////////////////////////
+#if __cplusplus >= 202002L && defined(__cpp_constexpr) && __cpp_constexpr >= 201907L
+#define FIXEDSTRING_CONSTEXPR constexpr
+#define FIXEDSTRING_HAS_CONSTEXPR 1
+#else
+#define FIXEDSTRING_CONSTEXPR
+#endif
+
+#if defined(FIXEDSTRING_AVX2)
+#include <immintrin.h>
+#elif defined(FIXEDSTRING_SSE2)
+#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//  Radix
+//  used for number <-> string conversion
+///////////////////////////////////////////////////////////////////////////////////////////
+enum Radix { base2 = 2, base8 = 8, base10 = 10, base16 = 16 };
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringParse
+// Result of a checked number parse (std::from_chars rules): pos is the index of the first
+// char not used, error is invalid if there was no number at the start, out_of_range if it
+// does not fit the type (pos is then past the number and the value is unchanged).
+///////////////////////////////////////////////////////////////////////////////////////////
+struct FixedStringParse
+{
+	enum Error { none = 0, invalid, out_of_range };
+	unsigned int pos;
+	Error error;
+	bool ok()const { return error == none; }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringKernels
+// Length bounded search kernels used by FixedString.
+// Unlike strchr/strstr these never look for the terminating null char, they only ever
+// read the [data, data + len) range given, so the cached length is all that is needed.
+// All return NULL if not found.
+// The public kernels are constexpr (C++20) and fall back to plain loops when evaluated at
+// compile time, the rt:: versions are the runtime (SIMD or libc) implementations.
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace FixedStringKernels
+{
+	using size_type = size_t;
+
+	inline FIXEDSTRING_CONSTEXPR bool in_constant_evaluation()
+	{
+#if defined(FIXEDSTRING_HAS_CONSTEXPR)
+		return __builtin_is_constant_evaluated();
+#else
+		return false;
+#endif
+	}
+
+	namespace rt
+	{
+#if defined(FIXEDSTRING_SSE2)
+		//Bit index helpers for the movemask results
+		inline unsigned first_bit(unsigned mask) { return static_cast<unsigned>(__builtin_ctz(mask)); }
+		inline unsigned last_bit(unsigned mask) { return 31u - static_cast<unsigned>(__builtin_clz(mask)); }
+#endif
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Single char search
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline const char* find_char(const char* data, size_type len, char c)
+		{
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			const __m256i v_c32 = _mm256_set1_epi8(c);
+			for (; i + 32 <= len; i += 32)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+				const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, v_c32)));
+				if (mask != 0)
+					return data + i + first_bit(mask);
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			const __m128i v_c = _mm_set1_epi8(c);
+			for (; i + 16 <= len; i += 16)
+			{
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, v_c)));
+				if (mask != 0)
+					return data + i + first_bit(mask);
+			}
+			if (i < len && len >= 16)
+			{
+				//Overlapping final block rather than a scalar tail
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + len - 16));
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, v_c)));
+				return mask != 0 ? data + len - 16 + first_bit(mask) : NULL;
+			}
+#endif
+			//memchr is length bounded too
+			return i < len ? static_cast<const char*>(memchr(data + i, c, len - i)) : NULL;
+		}
+
+		inline const char* find_last_char(const char* data, size_type len, char c)
+		{
+			size_type i = len;
+#if defined(FIXEDSTRING_AVX2)
+			const __m256i v_c32 = _mm256_set1_epi8(c);
+			for (; i >= 32; i -= 32)
+			{
+				const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i - 32));
+				const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, v_c32)));
+				if (mask != 0)
+					return data + i - 32 + last_bit(mask);
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			const __m128i v_c = _mm_set1_epi8(c);
+			for (; i >= 16; i -= 16)
+			{
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - 16));
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, v_c)));
+				if (mask != 0)
+					return data + i - 16 + last_bit(mask);
+			}
+			if (i > 0 && len >= 16)
+			{
+				//Overlapping first block rather than a scalar tail
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, v_c))) & ((1u << i) - 1u);
+				return mask != 0 ? data + last_bit(mask) : NULL;
+			}
+#endif
+			while (i > 0)
+			{
+				if (data[--i] == c)
+					return data + i;
+			}
+			return NULL;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Sub string search
+		// Candidate positions are found by matching both the first AND last char of the
+		// needle across a whole block, only those candidates are then fully compared.
+		// This keeps the search a single linear pass for typical text.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline bool match_at(const char* p, const char* needle, size_type needle_len)
+		{
+			//First and last chars already matched by caller
+			return needle_len <= 2 || memcmp(p + 1, needle + 1, needle_len - 2) == 0;
+		}
+
+		inline const char* find_str(const char* data, size_type len, const char* needle, size_type needle_len)
+		{
+			if (needle_len == 0 || needle_len > len)
+				return NULL;
+			if (needle_len == 1)
+				return find_char(data, len, needle[0]);
+			const size_type last_start = len - needle_len;//Last valid match position
+			const char first = needle[0];
+			const char last = needle[needle_len - 1];
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			const __m256i v_first32 = _mm256_set1_epi8(first);
+			const __m256i v_last32 = _mm256_set1_epi8(last);
+			for (; i + 32 <= last_start + 1; i += 32)
+			{
+				const __m256i b_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+				const __m256i b_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + needle_len - 1));
+				unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+					_mm256_and_si256(_mm256_cmpeq_epi8(b_first, v_first32), _mm256_cmpeq_epi8(b_last, v_last32))));
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const char* p = data + i + first_bit(mask);
+					if (match_at(p, needle, needle_len))
+						return p;
+				}
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			const __m128i v_first = _mm_set1_epi8(first);
+			const __m128i v_last = _mm_set1_epi8(last);
+			for (; i + 16 <= last_start + 1; i += 16)
+			{
+				const __m128i b_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+				const __m128i b_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + needle_len - 1));
+				unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+					_mm_and_si128(_mm_cmpeq_epi8(b_first, v_first), _mm_cmpeq_epi8(b_last, v_last))));
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const char* p = data + i + first_bit(mask);
+					if (match_at(p, needle, needle_len))
+						return p;
+				}
+			}
+#endif
+			for (; i <= last_start; i++)
+			{
+				if (data[i] == first && data[i + needle_len - 1] == last && match_at(data + i, needle, needle_len))
+					return data + i;
+			}
+			return NULL;
+		}
+
+		inline const char* find_last_str(const char* data, size_type len, const char* needle, size_type needle_len)
+		{
+			if (needle_len == 0 || needle_len > len)
+				return NULL;
+			if (needle_len == 1)
+				return find_last_char(data, len, needle[0]);
+			const char first = needle[0];
+			const char last = needle[needle_len - 1];
+			//Candidate start positions are [0, end)
+			size_type end = len - needle_len + 1;
+#if defined(FIXEDSTRING_AVX2)
+			const __m256i v_first32 = _mm256_set1_epi8(first);
+			const __m256i v_last32 = _mm256_set1_epi8(last);
+			for (; end >= 32; end -= 32)
+			{
+				const char* base = data + end - 32;
+				const __m256i b_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base));
+				const __m256i b_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + needle_len - 1));
+				unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+					_mm256_and_si256(_mm256_cmpeq_epi8(b_first, v_first32), _mm256_cmpeq_epi8(b_last, v_last32))));
+				while (mask != 0)
+				{
+					const auto bit = last_bit(mask);
+					if (match_at(base + bit, needle, needle_len))
+						return base + bit;
+					mask &= ~(1u << bit);
+				}
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			const __m128i v_first = _mm_set1_epi8(first);
+			const __m128i v_last = _mm_set1_epi8(last);
+			for (; end >= 16; end -= 16)
+			{
+				const char* base = data + end - 16;
+				const __m128i b_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base));
+				const __m128i b_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + needle_len - 1));
+				unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+					_mm_and_si128(_mm_cmpeq_epi8(b_first, v_first), _mm_cmpeq_epi8(b_last, v_last))));
+				while (mask != 0)
+				{
+					const auto bit = last_bit(mask);
+					if (match_at(base + bit, needle, needle_len))
+						return base + bit;
+					mask &= ~(1u << bit);
+				}
+			}
+#endif
+			while (end > 0)
+			{
+				const char* p = data + --end;
+				if (p[0] == first && p[needle_len - 1] == last && match_at(p, needle, needle_len))
+					return p;
+			}
+			return NULL;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// ASCII case insensitive compare
+		// 'A'-'Z' are folded to lower case a block at a time: (c > '@' && c < '[') selects the
+		// upper case bytes (signed compares, so bytes >= 0x80 are never folded) then 0x20 is
+		// or'ed in. Without SIMD, and for the tail, 8 bytes are folded at once in a uint64_t.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline char fold_case(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c; }
+		inline int fold_diff(char lhs, char rhs)
+		{
+			return static_cast<int>(static_cast<unsigned char>(fold_case(lhs))) - static_cast<unsigned char>(fold_case(rhs));
+		}
+		inline int compare_ignore_case_bytes(const char* lhs, const char* rhs, size_type len)
+		{
+			for (size_type i = 0; i < len; i++)
+			{
+				const auto diff = fold_diff(lhs[i], rhs[i]);
+				if (diff != 0)
+					return diff;
+			}
+			return 0;
+		}
+#ifndef ARDUINO
+		inline uint64_t load_word(const char* p)
+		{
+			uint64_t v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+		//0x20 in each byte of v in [first, last], bytes >= 0x80 are never selected
+		inline uint64_t case_bits(uint64_t v, char first, char last)
+		{
+			const uint64_t ones = 0x0101010101010101ull;
+			const uint64_t low7 = v & (ones * 0x7F);
+			const uint64_t ge_first = low7 + ones * static_cast<uint64_t>(0x80 - first);//High bit set if >= first, no carry between bytes
+			const uint64_t gt_last = low7 + ones * static_cast<uint64_t>(0x80 - last - 1);//High bit set if > last
+			return (ge_first & ~gt_last & ~v & (ones * 0x80)) >> 2;
+		}
+		inline uint64_t fold_case(uint64_t v) { return v | case_bits(v, 'A', 'Z'); }
+		inline bool fold_equal_word(const char* lhs, const char* rhs) { return fold_case(load_word(lhs)) == fold_case(load_word(rhs)); }
+#endif
+		inline int compare_ignore_case_tail(const char* lhs, const char* rhs, size_type len)
+		{
+#ifndef ARDUINO
+			if (len >= 8)
+			{
+				//Whole words, the last one overlapping so there is no byte tail
+				size_type i = 0;
+				for (; i + 8 < len; i += 8)
+				{
+					if (!fold_equal_word(lhs + i, rhs + i))
+						return compare_ignore_case_bytes(lhs + i, rhs + i, 8);
+				}
+				i = len - 8;
+				return fold_equal_word(lhs + i, rhs + i) ? 0 : compare_ignore_case_bytes(lhs + i, rhs + i, 8);
+			}
+#endif
+			return compare_ignore_case_bytes(lhs, rhs, len);
+		}
+#if defined(FIXEDSTRING_AVX2)
+		inline __m256i fold_case(__m256i v)
+		{
+			const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+			return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+		}
+		inline __m256i fold_equal32(const char* lhs, const char* rhs)
+		{
+			return _mm256_cmpeq_epi8(fold_case(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs))),
+				fold_case(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs))));
+		}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+		inline __m128i fold_case(__m128i v)
+		{
+			const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+			return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+		}
+		inline __m128i fold_equal16(const char* lhs, const char* rhs)
+		{
+			return _mm_cmpeq_epi8(fold_case(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs))),
+				fold_case(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs))));
+		}
+#endif
+		inline int compare_ignore_case(const char* lhs, const char* rhs, size_type len)
+		{
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			//64 bytes per step, a mismatch is then located by the 32 byte loop
+			for (; i + 64 <= len; i += 64)
+			{
+				const __m256i eq = _mm256_and_si256(fold_equal32(lhs + i, rhs + i), fold_equal32(lhs + i + 32, rhs + i + 32));
+				if (_mm256_movemask_epi8(eq) != -1)
+					break;
+			}
+			for (; i + 32 <= len; i += 32)
+			{
+				const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(fold_equal32(lhs + i, rhs + i)));
+				if (mask != 0)
+				{
+					i += first_bit(mask);
+					return fold_diff(lhs[i], rhs[i]);
+				}
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			for (; i + 64 <= len; i += 64)
+			{
+				const __m128i eq = _mm_and_si128(_mm_and_si128(fold_equal16(lhs + i, rhs + i), fold_equal16(lhs + i + 16, rhs + i + 16)),
+					_mm_and_si128(fold_equal16(lhs + i + 32, rhs + i + 32), fold_equal16(lhs + i + 48, rhs + i + 48)));
+				if (_mm_movemask_epi8(eq) != 0xFFFF)
+					break;
+			}
+			for (; i + 16 <= len; i += 16)
+			{
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(fold_equal16(lhs + i, rhs + i))) ^ 0xFFFFu;
+				if (mask != 0)
+				{
+					i += first_bit(mask);
+					return fold_diff(lhs[i], rhs[i]);
+				}
+			}
+			if (i < len && len >= 16)
+			{
+				//Overlapping final block, all before i already matched so its first mismatch is the first overall
+				const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(fold_equal16(lhs + len - 16, rhs + len - 16))) ^ 0xFFFFu;
+				if (mask == 0)
+					return 0;
+				i = len - 16 + first_bit(mask);
+				return fold_diff(lhs[i], rhs[i]);
+			}
+#endif
+			return compare_ignore_case_tail(lhs + i, rhs + i, len - i);
+		}
+
+		//As compare_ignore_case() but lhs & rhs always have 16 readable bytes (e.g. FixedString storage)
+		//so a short string is a single masked block
+		inline int compare_ignore_case_block(const char* lhs, const char* rhs, size_type len)
+		{
+#if defined(FIXEDSTRING_SSE2)
+			if (len < 16)
+			{
+				const unsigned mask = (static_cast<unsigned>(_mm_movemask_epi8(fold_equal16(lhs, rhs))) ^ 0xFFFFu) & ((1u << len) - 1);
+				if (mask == 0)
+					return 0;
+				const auto i = first_bit(mask);
+				return fold_diff(lhs[i], rhs[i]);
+			}
+#endif
+			return compare_ignore_case(lhs, rhs, len);
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// ASCII case mapping
+		// The bytes in [first, last] ('A'-'Z' to lower, 'a'-'z' to upper) have 0x20 flipped a
+		// whole block at a time, the rest (including bytes >= 0x80) are unchanged - tolower() &
+		// toupper() in the "C" locale. Mapping again changes nothing so the last block overlaps
+		// rather than leaving a byte tail. Without SIMD 8 bytes are mapped at once.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline void map_case_bytes(char* data, size_type len, char first, char last)
+		{
+			for (size_type i = 0; i < len; i++)
+			{
+				if (data[i] >= first && data[i] <= last)
+					data[i] = static_cast<char>(data[i] ^ 0x20);
+			}
+		}
+#ifndef ARDUINO
+		inline void map_case_word(char* p, char first, char last)
+		{
+			const uint64_t v = load_word(p);
+			const uint64_t mapped = v ^ case_bits(v, first, last);
+			memcpy(p, &mapped, sizeof(mapped));
+		}
+#endif
+#if defined(FIXEDSTRING_AVX2)
+		inline void map_case32(char* p, char first, char last)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(first - 1))), _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(last + 1)), v));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_xor_si256(v, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20))));
+		}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+		inline void map_case16(char* p, char first, char last)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(first - 1))), _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(last + 1))));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_xor_si128(v, _mm_and_si128(in_range, _mm_set1_epi8(0x20))));
+		}
+#endif
+		//c_max_len: the longest len can be, no block wider than that is compiled in
+		template<size_type c_max_len>
+		inline void map_case(char* data, size_type len, char first, char last)
+		{
+#if defined(FIXEDSTRING_AVX2)
+			if (c_max_len >= 32 && len >= 32)
+			{
+				size_type i = 0;
+				for (; i + 32 <= len; i += 32)
+					map_case32(data + i, first, last);
+				if (i < len)
+					map_case32(data + len - 32, first, last);
+				return;
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			if (c_max_len >= 16 && len >= 16)
+			{
+				size_type i = 0;
+				for (; i + 16 <= len; i += 16)
+					map_case16(data + i, first, last);
+				if (i < len)
+					map_case16(data + len - 16, first, last);
+				return;
+			}
+#endif
+#ifndef ARDUINO
+			if (c_max_len >= 8 && len >= 8)
+			{
+				size_type i = 0;
+				for (; i + 8 <= len; i += 8)
+					map_case_word(data + i, first, last);
+				if (i < len)
+					map_case_word(data + len - 8, first, last);
+				return;
+			}
+#endif
+			map_case_bytes(data, len, first, last);
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// White space
+		// ' ' and '\t'-'\r', isspace() in the "C" locale. The mask of the non space bytes in a
+		// block gives the first (or last) directly. Most text has none to skip so the first
+		// byte is checked before any block.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+#if defined(FIXEDSTRING_AVX2)
+		inline unsigned not_space_mask32(const char* p)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+				_mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)));
+			return ~static_cast<unsigned>(_mm256_movemask_epi8(space));
+		}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+		inline unsigned not_space_mask16(const char* p)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+				_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+			return static_cast<unsigned>(_mm_movemask_epi8(space)) ^ 0xFFFFu;
+		}
+#endif
+		template<size_type c_max_len>
+		inline const char* find_not_space(const char* data, size_type len)
+		{
+			if (len == 0 || !is_space(data[0]))
+				return len == 0 ? NULL : data;
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			for (; c_max_len >= 32 && i + 32 <= len; i += 32)
+			{
+				const unsigned mask = not_space_mask32(data + i);
+				if (mask != 0)
+					return data + i + first_bit(mask);
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			for (; c_max_len >= 16 && i + 16 <= len; i += 16)
+			{
+				const unsigned mask = not_space_mask16(data + i);
+				if (mask != 0)
+					return data + i + first_bit(mask);
+			}
+#endif
+			for (; i < len; i++)
+			{
+				if (!is_space(data[i]))
+					return data + i;
+			}
+			return NULL;
+		}
+		template<size_type c_max_len>
+		inline const char* find_last_not_space(const char* data, size_type len)
+		{
+			if (len == 0 || !is_space(data[len - 1]))
+				return len == 0 ? NULL : data + len - 1;
+#if defined(FIXEDSTRING_AVX2)
+			for (; c_max_len >= 32 && len >= 32; len -= 32)
+			{
+				const unsigned mask = not_space_mask32(data + len - 32);
+				if (mask != 0)
+					return data + len - 32 + last_bit(mask);
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			for (; c_max_len >= 16 && len >= 16; len -= 16)
+			{
+				const unsigned mask = not_space_mask16(data + len - 16);
+				if (mask != 0)
+					return data + len - 16 + last_bit(mask);
+			}
+#endif
+			while (len > 0)
+			{
+				if (!is_space(data[--len]))
+					return data + len;
+			}
+			return NULL;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Zero padded equality
+		// Both blocks are n bytes (a multiple of 4) and every byte at or after used is zero in
+		// both, so whole blocks can be compared with no tail handling.
+		// Past 64 bytes the length bounded memcmp() is as fast, so is used instead.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline bool equal_padded(const char* lhs, const char* rhs, size_type used, size_type n)
+		{
+			if (n > 64 && used > 64)
+				return memcmp(lhs, rhs, used) == 0;
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			for (; i < used && i + 64 <= n; i += 64)
+			{
+				const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+				const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+				const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i + 32));
+				const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i + 32));
+				const __m256i diff = _mm256_or_si256(_mm256_xor_si256(a0, b0), _mm256_xor_si256(a1, b1));
+				if (!_mm256_testz_si256(diff, diff))
+					return false;
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			if (n >= 16)
+			{
+				for (; i < used && i + 64 <= n; i += 64)
+				{
+					__m128i diff = _mm_setzero_si128();
+					for (size_type j = 0; j < 64; j += 16)
+					{
+						diff = _mm_or_si128(diff, _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i + j)),
+							_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i + j))));
+					}
+					if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF)
+						return false;
+				}
+				for (; i < used && i + 16 <= n; i += 16)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+					if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+						return false;
+				}
+				if (i >= used)
+					return true;
+				//n is not a multiple of 16: overlapping final block
+				const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + n - 16));
+				const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + n - 16));
+				return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF;
+			}
+#endif
+			for (; i < used; i += 4)
+			{
+				uint32_t a;
+				uint32_t b;
+				memcpy(&a, lhs + i, 4);
+				memcpy(&b, rhs + i, 4);
+				if (a != b)
+					return false;
+			}
+			return true;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Prefix copy
+		// Copies at least the first len of n bytes (len <= n, n >= 16) as whole 16 byte blocks,
+		// the last one ending at n where a block would pass it. Inline fixed size moves instead
+		// of a memcpy() call, which costs more than the bytes for the few blocks of a short string.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline void copy_prefix_block(char* dest, const char* src, size_type len, size_type n)
+		{
+			size_type i = 0;
+			for (; i < len && i + 16 <= n; i += 16)
+				memcpy(dest + i, src + i, 16);
+			if (i < len)
+				memcpy(dest + n - 16, src + n - 16, 16);
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Prefix equality
+		// [lhs, lhs + len) == [rhs, rhs + len) where both have n readable bytes (len <= n), so
+		// whole blocks are compared and only the mask of the last one is cut to len.
+		///////////////////////////////////////////////////////////////////////////////////////
+		inline bool equal_prefix_block(const char* lhs, const char* rhs, size_type len, size_type n)
+		{
+#if defined(FIXEDSTRING_AVX2)
+			if (n % 32 == 0)
+			{
+				for (size_type i = 0; i < len; i += 32)
+				{
+					const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+					const uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+					if (len - i < 32)
+						return (diff & ((1u << (len - i)) - 1)) == 0;
+					if (diff != 0)
+						return false;
+				}
+				return true;
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			if (n % 16 == 0)
+			{
+				for (size_type i = 0; i < len; i += 16)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+					const unsigned diff = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xFFFFu;
+					if (len - i < 16)
+						return (diff & ((1u << (len - i)) - 1)) == 0;
+					if (diff != 0)
+						return false;
+				}
+				return true;
+			}
+#endif
+			(void)n;
+			return memcmp(lhs, rhs, len) == 0;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Match masks
+		// Bit i is set if data[i] == c, for a whole block (c_mask_block bytes must be readable)
+		// so a caller can walk every match in the block without searching again.
+		///////////////////////////////////////////////////////////////////////////////////////
+#if defined(FIXEDSTRING_AVX2)
+		inline uint32_t match_mask(const char* data, char c)
+		{
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+		}
+#elif defined(FIXEDSTRING_SSE2)
+		inline uint32_t match_mask(const char* data, char c)
+		{
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+		}
+#endif
+
+		///////////////////////////////////////////////////////////////////////////////////////
+		// Length column masks
+		// Bit i is set if lens[i] == len (lens[i] >= len if at_least), for i < n <= 32, so a
+		// column of lengths (FixedStringArray) rules rows out a block at a time. len must fit
+		// the length type. 1 and 2 byte lengths are compared 16 at a time, only whole blocks
+		// are read.
+		///////////////////////////////////////////////////////////////////////////////////////
+		template<typename T>
+		inline uint32_t length_mask_tail(const T* lens, size_type i, size_type n, size_type len, bool at_least)
+		{
+			uint32_t mask = 0;
+			for (; i < n; i++)
+				mask |= static_cast<uint32_t>(at_least ? lens[i] >= len : lens[i] == len) << i;
+			return mask;
+		}
+		template<typename T>
+		inline uint32_t length_mask(const T* lens, size_type n, size_type len, bool at_least)
+		{
+			return length_mask_tail(lens, 0, n, len, at_least);
+		}
+		inline uint32_t length_mask(const uint8_t* lens, size_type n, size_type len, bool at_least)
+		{
+			uint32_t mask = 0;
+			size_type i = 0;
+#if defined(FIXEDSTRING_AVX2)
+			if (n == 32)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lens));
+				const __m256i key = _mm256_set1_epi8(static_cast<char>(len));
+				return static_cast<uint32_t>(_mm256_movemask_epi8(at_least ? _mm256_cmpeq_epi8(_mm256_max_epu8(v, key), v) : _mm256_cmpeq_epi8(v, key)));
+			}
+#endif
+#if defined(FIXEDSTRING_SSE2)
+			const __m128i key = _mm_set1_epi8(static_cast<char>(len));
+			for (; i + 16 <= n; i += 16)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lens + i));
+				const __m128i hit = at_least ? _mm_cmpeq_epi8(_mm_max_epu8(v, key), v) : _mm_cmpeq_epi8(v, key);
+				mask |= static_cast<uint32_t>(_mm_movemask_epi8(hit)) << i;
+			}
+#endif
+			return mask | length_mask_tail(lens, i, n, len, at_least);
+		}
+		inline uint32_t length_mask(const uint16_t* lens, size_type n, size_type len, bool at_least)
+		{
+			uint32_t mask = 0;
+			size_type i = 0;
+#if defined(FIXEDSTRING_SSE2)
+			//No unsigned 16 bit compare in SSE2: flip the sign bits and compare signed
+			const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+			const __m128i key = _mm_set1_epi16(static_cast<short>(len));
+			const __m128i key_biased = _mm_xor_si128(key, bias);
+			for (; i + 16 <= n; i += 16)
+			{
+				const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lens + i));
+				const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lens + i + 8));
+				const __m128i hit = at_least
+					? _mm_packs_epi16(_mm_cmpgt_epi16(key_biased, _mm_xor_si128(v0, bias)), _mm_cmpgt_epi16(key_biased, _mm_xor_si128(v1, bias)))
+					: _mm_packs_epi16(_mm_cmpeq_epi16(v0, key), _mm_cmpeq_epi16(v1, key));
+				const uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+				mask |= (at_least ? bits ^ 0xFFFFu : bits) << i;	//at_least: the lanes not below len
+			}
+#endif
+			return mask | length_mask_tail(lens, i, n, len, at_least);
+		}
+	}
+
+	//Block size of match_mask()
+#if defined(FIXEDSTRING_SSE2) && !defined(FIXEDSTRING_AVX2)
+	constexpr size_type c_mask_block = 16;
+#else
+	constexpr size_type c_mask_block = 32;
+#endif
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Scalar versions - usable in constant expressions
+	///////////////////////////////////////////////////////////////////////////////////////
+	inline FIXEDSTRING_CONSTEXPR size_type scalar_length(const char* str)
+	{
+		size_type len = 0;
+		while (str[len] != '\0')
+			len++;
+		return len;
+	}
+	inline FIXEDSTRING_CONSTEXPR int scalar_compare(const char* lhs, const char* rhs, size_type len)
+	{
+		for (size_type i = 0; i < len; i++)
+		{
+			if (lhs[i] != rhs[i])
+				return static_cast<unsigned char>(lhs[i]) < static_cast<unsigned char>(rhs[i]) ? -1 : 1;
+		}
+		return 0;
+	}
+	inline FIXEDSTRING_CONSTEXPR const char* scalar_find_char(const char* data, size_type len, char c)
+	{
+		for (size_type i = 0; i < len; i++)
+		{
+			if (data[i] == c)
+				return data + i;
+		}
+		return NULL;
+	}
+	inline FIXEDSTRING_CONSTEXPR const char* scalar_find_last_char(const char* data, size_type len, char c)
+	{
+		while (len > 0)
+		{
+			if (data[--len] == c)
+				return data + len;
+		}
+		return NULL;
+	}
+	inline FIXEDSTRING_CONSTEXPR const char* scalar_find_str(const char* data, size_type len, const char* needle, size_type needle_len, bool last)
+	{
+		if (needle_len == 0 || needle_len > len)
+			return NULL;
+		const char* found = NULL;
+		for (size_type i = 0; i + needle_len <= len; i++)
+		{
+			if (scalar_compare(data + i, needle, needle_len) != 0)
+				continue;
+			found = data + i;
+			if (!last)
+				break;
+		}
+		return found;
+	}
+	inline FIXEDSTRING_CONSTEXPR uint32_t scalar_match_mask(const char* data, size_type len, char c)
+	{
+		uint32_t mask = 0;
+		uint32_t bit = 1;
+		for (size_type i = 0; i < len && i < c_mask_block; i++, bit <<= 1)
+		{
+			if (data[i] == c)
+				mask |= bit;
+		}
+		return mask;
+	}
+	inline FIXEDSTRING_CONSTEXPR int scalar_compare_ignore_case(const char* lhs, const char* rhs, size_type len)
+	{
+		for (size_type i = 0; i < len; i++)
+		{
+			const unsigned char a = static_cast<unsigned char>((lhs[i] >= 'A' && lhs[i] <= 'Z') ? lhs[i] | 0x20 : lhs[i]);
+			const unsigned char b = static_cast<unsigned char>((rhs[i] >= 'A' && rhs[i] <= 'Z') ? rhs[i] | 0x20 : rhs[i]);
+			if (a != b)
+				return static_cast<int>(a) - b;
+		}
+		return 0;
+	}
+
+	inline FIXEDSTRING_CONSTEXPR void scalar_map_case(char* data, size_type len, char first, char last)
+	{
+		for (size_type i = 0; i < len; i++)
+		{
+			if (data[i] >= first && data[i] <= last)
+				data[i] = static_cast<char>(data[i] ^ 0x20);
+		}
+	}
+	inline FIXEDSTRING_CONSTEXPR bool scalar_is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+	inline FIXEDSTRING_CONSTEXPR const char* scalar_find_not_space(const char* data, size_type len)
+	{
+		for (size_type i = 0; i < len; i++)
+		{
+			if (!scalar_is_space(data[i]))
+				return data + i;
+		}
+		return NULL;
+	}
+	inline FIXEDSTRING_CONSTEXPR const char* scalar_find_last_not_space(const char* data, size_type len)
+	{
+		while (len > 0)
+		{
+			if (!scalar_is_space(data[--len]))
+				return data + len;
+		}
+		return NULL;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Public kernels
+	// c_simd == false selects the scalar code, used where the data can never fill a
+	// SIMD block (e.g. small strings).
+	///////////////////////////////////////////////////////////////////////////////////////
+	inline FIXEDSTRING_CONSTEXPR size_type length(const char* str)
+	{
+		return in_constant_evaluation() ? scalar_length(str) : strlen(str);
+	}
+	//memcmp() semantics
+	inline FIXEDSTRING_CONSTEXPR int compare(const char* lhs, const char* rhs, size_type len)
+	{
+		return in_constant_evaluation() ? scalar_compare(lhs, rhs, len) : memcmp(lhs, rhs, len);
+	}
+	//memmove() semantics
+	inline FIXEDSTRING_CONSTEXPR void move(char* dest, const char* src, size_type len)
+	{
+		if (!in_constant_evaluation())
+		{
+			memmove(dest, src, len);
+			return;
+		}
+		//Compile time: pointers to different objects cannot be compared so copy via a transient buffer
+		char* temp = new char[len + 1];
+		for (size_type i = 0; i < len; i++)
+			temp[i] = src[i];
+		for (size_type i = 0; i < len; i++)
+			dest[i] = temp[i];
+		delete[] temp;
+	}
+	inline FIXEDSTRING_CONSTEXPR void fill(char* dest, char c, size_type len)
+	{
+		if (!in_constant_evaluation())
+			memset(dest, c, len);
+		else
+		{
+			for (size_type i = 0; i < len; i++)
+				dest[i] = c;
+		}
+	}
+	//ASCII case insensitive, memcmp() semantics on the lower cased bytes
+	//c_block16: both always have 16 readable bytes, even if len is less
+	template<bool c_block16 = false>
+	inline FIXEDSTRING_CONSTEXPR int compare_ignore_case(const char* lhs, const char* rhs, size_type len)
+	{
+		return in_constant_evaluation() ? scalar_compare_ignore_case(lhs, rhs, len)
+			: c_block16 ? rt::compare_ignore_case_block(lhs, rhs, len) : rt::compare_ignore_case(lhs, rhs, len);
+	}
+	//ASCII ("C" locale) case mapping in place
+	//c_max_len: the longest len can be (a FixedString's capacity), no block wider is compiled in
+	template<size_type c_max_len = static_cast<size_type>(-1)>
+	inline FIXEDSTRING_CONSTEXPR void to_lower(char* data, size_type len)
+	{
+		if (in_constant_evaluation())
+			scalar_map_case(data, len, 'A', 'Z');
+		else
+			rt::map_case<c_max_len>(data, len, 'A', 'Z');
+	}
+	template<size_type c_max_len = static_cast<size_type>(-1)>
+	inline FIXEDSTRING_CONSTEXPR void to_upper(char* data, size_type len)
+	{
+		if (in_constant_evaluation())
+			scalar_map_case(data, len, 'a', 'z');
+		else
+			rt::map_case<c_max_len>(data, len, 'a', 'z');
+	}
+	//First & last char that is not white space (' ', '\t'-'\r')
+	template<size_type c_max_len = static_cast<size_type>(-1)>
+	inline FIXEDSTRING_CONSTEXPR const char* find_not_space(const char* data, size_type len)
+	{
+		return in_constant_evaluation() ? scalar_find_not_space(data, len) : rt::find_not_space<c_max_len>(data, len);
+	}
+	template<size_type c_max_len = static_cast<size_type>(-1)>
+	inline FIXEDSTRING_CONSTEXPR const char* find_last_not_space(const char* data, size_type len)
+	{
+		return in_constant_evaluation() ? scalar_find_last_not_space(data, len) : rt::find_last_not_space<c_max_len>(data, len);
+	}
+	//[lhs, lhs + n) == [rhs, rhs + n) where both are zero from used onwards, n % 4 == 0
+	inline FIXEDSTRING_CONSTEXPR bool equal_padded(const char* lhs, const char* rhs, size_type used, size_type n)
+	{
+		return in_constant_evaluation() ? scalar_compare(lhs, rhs, n) == 0 : rt::equal_padded(lhs, rhs, used, n);
+	}
+	//[lhs, lhs + len) == [rhs, rhs + len) where both have n readable bytes, len <= n
+	inline FIXEDSTRING_CONSTEXPR bool equal_prefix_block(const char* lhs, const char* rhs, size_type len, size_type n)
+	{
+		return in_constant_evaluation() ? scalar_compare(lhs, rhs, len) == 0 : rt::equal_prefix_block(lhs, rhs, len, n);
+	}
+	//Bit i set if data[i] == c, for i < min(len, c_mask_block)
+	inline FIXEDSTRING_CONSTEXPR uint32_t match_mask(const char* data, size_type len, char c)
+	{
+#if defined(FIXEDSTRING_SSE2)
+		if (!in_constant_evaluation() && len >= c_mask_block)
+			return rt::match_mask(data, c);
+#endif
+		return scalar_match_mask(data, len, c);
+	}
+	//Index of the lowest set bit, mask != 0
+	inline FIXEDSTRING_CONSTEXPR unsigned lowest_bit(uint32_t mask)
+	{
+		if (in_constant_evaluation())
+		{
+			unsigned i = 0;
+			for (; (mask & 1u) == 0; mask >>= 1)
+				i++;
+			return i;
+		}
+		return static_cast<unsigned>(__builtin_ctzl(mask));
+	}
+	template<bool c_simd = true>
+	inline FIXEDSTRING_CONSTEXPR const char* find_char(const char* data, size_type len, char c)
+	{
+		return (!c_simd || in_constant_evaluation()) ? scalar_find_char(data, len, c) : rt::find_char(data, len, c);
+	}
+	template<bool c_simd = true>
+	inline FIXEDSTRING_CONSTEXPR const char* find_last_char(const char* data, size_type len, char c)
+	{
+		return (!c_simd || in_constant_evaluation()) ? scalar_find_last_char(data, len, c) : rt::find_last_char(data, len, c);
+	}
+	template<bool c_simd = true>
+	inline FIXEDSTRING_CONSTEXPR const char* find_str(const char* data, size_type len, const char* needle, size_type needle_len)
+	{
+		return (!c_simd || in_constant_evaluation())
+			? scalar_find_str(data, len, needle, needle_len, false)
+			: rt::find_str(data, len, needle, needle_len);
+	}
+	template<bool c_simd = true>
+	inline FIXEDSTRING_CONSTEXPR const char* find_last_str(const char* data, size_type len, const char* needle, size_type needle_len)
+	{
+		return (!c_simd || in_constant_evaluation())
+			? scalar_find_str(data, len, needle, needle_len, true)
+			: rt::find_last_str(data, len, needle, needle_len);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Hashing
+	// Hash of [data, data + len) - equal text gives an equal hash whatever holds it
+	// (FixedString<N> of any N, const char*, std::string_view).
+	// Host: 8 bytes per step, mixed via a 64x64->128 bit multiply (wyhash style), the tail
+	// is read as overlapping words so there is no byte loop. Arduino: 32 bit FNV-1a.
+	///////////////////////////////////////////////////////////////////////////////////////
+#ifndef ARDUINO
+	//Little endian load of n (<= 8) bytes
+	inline FIXEDSTRING_CONSTEXPR uint64_t load_le(const char* p, size_type n)
+	{
+		uint64_t v = 0;
+		if (!in_constant_evaluation())
+		{
+			memcpy(&v, p, n);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			v = __builtin_bswap64(v) >> (64 - n * 8);
+#endif
+			return v;
+		}
+		for (size_type i = n; i > 0; i--)
+			v = (v << 8) | static_cast<unsigned char>(p[i - 1]);
+		return v;
+	}
+	inline FIXEDSTRING_CONSTEXPR uint64_t hash_mix(uint64_t a, uint64_t b)
+	{
+#if defined(__SIZEOF_INT128__)
+		__extension__ typedef unsigned __int128 uint128;
+		const uint128 r = static_cast<uint128>(a) * b;
+		return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#else
+		const uint64_t r = (a ^ (b >> 29)) * 0x9E3779B97F4A7C15ull + b;
+		return r ^ (r >> 32);
+#endif
+	}
+	inline FIXEDSTRING_CONSTEXPR size_type hash(const char* data, size_type len)
+	{
+		const uint64_t k0 = 0xa0761d6478bd642full;
+		const uint64_t k1 = 0xe7037ed1a0b428dbull;
+		const uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+		uint64_t h = k0;
+		size_type i = 0;
+		for (; i + 16 <= len; i += 16)
+			h = hash_mix(load_le(data + i, 8) ^ k1, load_le(data + i + 8, 8) ^ h);
+		const auto rest = len - i;
+		uint64_t a = 0;
+		uint64_t b = 0;
+		if (rest > 8)
+		{
+			a = load_le(data + i, 8);
+			b = load_le(data + len - 8, 8);
+		}
+		else if (rest >= 4)
+		{
+			a = load_le(data + i, 4);
+			b = load_le(data + len - 4, 4);
+		}
+		else if (rest > 0)
+		{
+			a = (static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << 16) |
+				(static_cast<uint64_t>(static_cast<unsigned char>(data[i + rest / 2])) << 8) |
+				static_cast<unsigned char>(data[len - 1]);
+		}
+		return static_cast<size_type>(hash_mix(k1 ^ len, hash_mix(a ^ k1, b ^ k2 ^ h)));
+	}
+#else
+	inline size_type hash(const char* data, size_type len)
+	{
+		uint32_t h = 2166136261ul;
+		for (size_type i = 0; i < len; i++)
+			h = (h ^ static_cast<unsigned char>(data[i])) * 16777619ul;
+		return static_cast<size_type>(h ^ (h >> 16));
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Integer to text
+	// Digits are written straight into the destination, no intermediate buffer.
+	// Radix may be any value in [2, 36], powers of 2 use shifts, base 10 writes two digits
+	// at a time from a lookup table (not on Arduino, to save RAM).
+	///////////////////////////////////////////////////////////////////////////////////////
+	inline const char* digit_chars() { return "0123456789abcdefghijklmnopqrstuvwxyz"; }
+#ifndef ARDUINO
+	inline const char* digit_pairs()
+	{
+		return "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+	}
+#endif
+	inline unsigned radix_shift(unsigned radix)
+	{
+		return radix == 2 ? 1u : radix == 4 ? 2u : radix == 8 ? 3u : radix == 16 ? 4u : 0u;
+	}
+	template<typename TUnsigned>
+	size_type count_digits(TUnsigned u, unsigned radix)
+	{
+		size_type cnt = 1;
+		if (radix == 10)
+		{
+			for (; u >= 10000u; u /= 10000u)
+				cnt += 4;
+			return cnt + (u >= 10u) + (u >= 100u) + (u >= 1000u);
+		}
+		const auto shift = radix_shift(radix);
+		if (shift != 0)
+		{
+			while ((u >>= shift) != 0)
+				cnt++;
+			return cnt;
+		}
+		while ((u /= radix) != 0)
+			cnt++;
+		return cnt;
+	}
+	//Write the lowest cnt digits of u to [dest, dest + cnt)
+	template<typename TUnsigned>
+	void write_digits(char* dest, TUnsigned u, size_type cnt, unsigned radix)
+	{
+		if (radix == 10)
+		{
+#ifndef ARDUINO
+			const char* pairs = digit_pairs();
+			for (; cnt >= 2; cnt -= 2)
+			{
+				const auto pair = static_cast<unsigned>(u % 100u) * 2;
+				u /= 100u;
+				dest[cnt - 2] = pairs[pair];
+				dest[cnt - 1] = pairs[pair + 1];
+			}
+#endif
+			for (; cnt > 0; u /= 10u)
+				dest[--cnt] = static_cast<char>('0' + static_cast<unsigned>(u % 10u));
+			return;
+		}
+		const char* digits = digit_chars();
+		const auto shift = radix_shift(radix);
+		if (shift != 0)
+		{
+			const auto mask = static_cast<TUnsigned>(radix - 1);
+			for (; cnt > 0; u >>= shift)
+				dest[--cnt] = digits[u & mask];
+			return;
+		}
+		for (; cnt > 0; u /= radix)
+			dest[--cnt] = digits[u % radix];
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Text to number
+	// parse_number() parses the number at the start of [data, data + len) with the
+	// std::from_chars rules: an optional '-' (signed types only), no leading space, '+' or
+	// radix prefix. Nothing past len is read.
+	// Host: std::from_chars, plus for base 10 integers 8 digits at a time from one 64 bit
+	// load (SWAR) while 8 bytes are left. Arduino: a digit loop, floats via strtod().
+	///////////////////////////////////////////////////////////////////////////////////////
+	inline unsigned digit_value(char c)
+	{
+		return c >= '0' && c <= '9' ? static_cast<unsigned>(c - '0')
+			: c >= 'a' && c <= 'z' ? static_cast<unsigned>(c - 'a' + 10)
+			: c >= 'A' && c <= 'Z' ? static_cast<unsigned>(c - 'A' + 10) : 36u;
+	}
+	inline FixedStringParse parse_result(size_type pos, FixedStringParse::Error error)
+	{
+		FixedStringParse res = { static_cast<unsigned int>(pos), error };
+		return res;
+	}
+#if !defined(ARDUINO) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	namespace rt
+	{
+		//Leading ASCII digits (0 - 8) of 8 chars, the first char in the low byte
+		inline unsigned digit_count8(uint64_t v)
+		{
+			const uint64_t high = 0xF0F0F0F0F0F0F0F0ull;
+			const uint64_t zeros = 0x3030303030303030ull;
+			//A byte is a digit if it is 0x3? and still 0x3? with 6 added (<= '9'). A carry out of
+			//a byte >= 0xFA only changes later bytes, after the first non digit
+			const uint64_t non_digit = ((v & high) ^ zeros) | (((v + 0x0606060606060606ull) & high) ^ zeros);
+			return non_digit == 0 ? 8u : static_cast<unsigned>(__builtin_ctzll(non_digit)) / 8u;
+		}
+		//Value of 8 ASCII digits
+		inline uint64_t eight_digits(uint64_t v)
+		{
+			v -= 0x3030303030303030ull;
+			v = v * 10 + (v >> 8);
+			return (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32)))
+				+ (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+		}
+		//Leading decimal digits of [data, data + len), false if there are more than 19 (may not fit)
+		inline bool parse_decimal(const char* data, size_type len, uint64_t& value, size_type& digits)
+		{
+			static const uint64_t pow10[9] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+			value = 0;
+			size_type i = 0;
+			while (len - i >= 8)
+			{
+				uint64_t v;
+				memcpy(&v, data + i, 8);
+				const unsigned n = digit_count8(v);
+				if (i + n > 19)
+					return false;
+				if (n == 0)
+					break;
+				//Fewer than 8: shift the digits up and fill below with '0's
+				if (n < 8)
+					v = (v << ((8 - n) * 8)) | (0x3030303030303030ull >> (n * 8));
+				value = value * pow10[n] + eight_digits(v);
+				i += n;
+				if (n < 8)
+				{
+					digits = i;
+					return true;
+				}
+			}
+			for (; i < len && data[i] >= '0' && data[i] <= '9'; i++)
+			{
+				if (i >= 19)
+					return false;
+				value = value * 10 + static_cast<unsigned>(data[i] - '0');
+			}
+			digits = i;
+			return true;
+		}
+	}
+#endif
+#ifndef ARDUINO
+	template<typename T>
+	FixedStringParse parse_number(const char* data, size_type len, T& value, int radix)
+	{
+		static_assert(std::numeric_limits<T>::is_integer, "parse_number needs an integer or floating point type");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		if (radix == 10)
+		{
+			const size_type neg = std::numeric_limits<T>::is_signed && len > 0 && data[0] == '-' ? 1 : 0;
+			uint64_t u;
+			size_type digits;
+			if (rt::parse_decimal(data + neg, len - neg, u, digits))
+			{
+				if (digits == 0)
+					return parse_result(0, FixedStringParse::invalid);
+				const uint64_t max = static_cast<uint64_t>(std::numeric_limits<T>::max()) + neg;
+				if (u > max)
+					return parse_result(neg + digits, FixedStringParse::out_of_range);
+				value = neg ? static_cast<T>(0 - u) : static_cast<T>(u);
+				return parse_result(neg + digits, FixedStringParse::none);
+			}
+		}
+#endif
+		const auto res = std::from_chars(data, data + len, value, radix);
+		return parse_result(static_cast<size_type>(res.ptr - data),
+			res.ec == std::errc() ? FixedStringParse::none : res.ec == std::errc::result_out_of_range ? FixedStringParse::out_of_range : FixedStringParse::invalid);
+	}
+	template<typename T>
+	FixedStringParse parse_float(const char* data, size_type len, T& value)
+	{
+		const auto res = std::from_chars(data, data + len, value);
+		return parse_result(static_cast<size_type>(res.ptr - data),
+			res.ec == std::errc() ? FixedStringParse::none : res.ec == std::errc::result_out_of_range ? FixedStringParse::out_of_range : FixedStringParse::invalid);
+	}
+	inline FixedStringParse parse_number(const char* data, size_type len, float& value, int) { return parse_float(data, len, value); }
+	inline FixedStringParse parse_number(const char* data, size_type len, double& value, int) { return parse_float(data, len, value); }
+#else
+	template<typename T>
+	FixedStringParse parse_number(const char* data, size_type len, T& value, int radix)
+	{
+		typedef unsigned long long TUnsigned;
+		const bool is_signed = static_cast<T>(-1) < static_cast<T>(0);
+		const size_type neg = is_signed && len > 0 && data[0] == '-' ? 1 : 0;
+		const unsigned bits = sizeof(T) * 8 - (is_signed ? 1 : 0);
+		const TUnsigned max = (bits >= 64 ? ~static_cast<TUnsigned>(0) : (static_cast<TUnsigned>(1) << bits) - 1) + neg;
+		TUnsigned u = 0;
+		bool overflow = false;
+		size_type i = neg;
+		for (unsigned d; i < len && (d = digit_value(data[i])) < static_cast<unsigned>(radix); i++)
+		{
+			if (u > (max - d) / static_cast<unsigned>(radix))
+				overflow = true;
+			else
+				u = u * static_cast<unsigned>(radix) + d;
+		}
+		if (i == neg)
+			return parse_result(0, FixedStringParse::invalid);
+		if (overflow)
+			return parse_result(i, FixedStringParse::out_of_range);
+		value = neg ? static_cast<T>(0 - u) : static_cast<T>(u);
+		return parse_result(i, FixedStringParse::none);
+	}
+	inline FixedStringParse parse_float(const char* data, size_type len, double& value)
+	{
+		//strtod() needs a terminated copy, and skips what from_chars() does not allow
+		char buf[32];
+		if (len == 0 || isspace(data[0]) || data[0] == '+')
+			return parse_result(0, FixedStringParse::invalid);
+		const size_type n = len < sizeof(buf) - 1 ? len : sizeof(buf) - 1;
+		memcpy(buf, data, n);
+		buf[n] = '\0';
+		char* end = buf;
+		errno = 0;
+		const double d = strtod(buf, &end);
+		if (end == buf)
+			return parse_result(0, FixedStringParse::invalid);
+		if (errno == ERANGE)
+			return parse_result(static_cast<size_type>(end - buf), FixedStringParse::out_of_range);
+		value = d;
+		return parse_result(static_cast<size_type>(end - buf), FixedStringParse::none);
+	}
+	inline FixedStringParse parse_number(const char* data, size_type len, double& value, int) { return parse_float(data, len, value); }
+	inline FixedStringParse parse_number(const char* data, size_type len, float& value, int)
+	{
+		double d = 0;
+		const FixedStringParse res = parse_float(data, len, d);
+		if (res.ok())
+			value = static_cast<float>(d);
+		return res;
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Varint lengths - the binary format (FixedString::serialize(), FixedStringSerial.h)
+	// 7 bits a byte, lowest first, the top bit set while more follow. Under 128 is the one
+	// byte, so a short string's 1 byte length and text are already in this format.
+	///////////////////////////////////////////////////////////////////////////////////////
+	static const size_type c_varint_max = 5;
+	inline constexpr size_type varint_size(uint32_t v) { return v < 0x80u ? 1u : 1u + varint_size(v >> 7); }
+	inline size_type put_varint(char* dest, uint32_t v)
+	{
+		size_type n = 0;
+		for (; v >= 0x80u; v >>= 7)
+			dest[n++] = static_cast<char>(v | 0x80u);
+		dest[n++] = static_cast<char>(v);
+		return n;
+	}
+	//Bytes read, 0 if [data, data + len) ends within the varint or it is over 32 bits
+	inline size_type get_varint(const char* data, size_type len, uint32_t& v)
+	{
+		uint32_t value = 0;
+		for (size_type i = 0; i < len && i < c_varint_max; i++)
+		{
+			const uint32_t b = static_cast<unsigned char>(data[i]);
+			if (i == c_varint_max - 1 && b > 0x0Fu)
+				return 0;
+			value |= (b & 0x7Fu) << (7 * i);
+			if (b < 0x80u)
+			{
+				v = value;
+				return i + 1;
+			}
+		}
+		return 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
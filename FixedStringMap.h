@@ -0,0 +1,196 @@
+// Fixed String - open addressing map keyed by FixedString
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGMAP_H
+#define _FIXEDSTRINGMAP_H
+#pragma once
+#include "FixedString.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringMap
+// A fixed size hash map with FixedString<c_key_size> keys stored inline, in its own slots:
+//		FixedStringMap<16, OrderBook*, 1024> books;
+//		books.insert("AAPL", &aapl);
+//		if (OrderBook** b = books.find("AAPL")) ...
+//
+// Linear probing over c_slots (a power of 2) slots. A separate byte per slot holds 7 bits
+// of the hash so a probe only touches a key when those bits match, and the probe bytes of
+// 64 slots share one cache line. Erase shifts later entries back (no tombstones).
+// At most capacity() (7/8 of c_slots) entries are held, insert returns NULL when full or
+// the key is longer than the key capacity (keys are never truncated).
+// Lookups take const char*, (const char*, len), a FixedStringView (or std::string_view) or
+// any FixedString<N>.
+// Value must be default constructible and assignable.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_key_size, typename Value, unsigned int c_slots = 64>
+class FixedStringMap
+{
+	static_assert(c_slots >= 8 && (c_slots & (c_slots - 1)) == 0, "FixedStringMap slot count must be a power of 2 (>= 8)");
+public:
+	using key_type = FixedString<c_key_size>;
+	using mapped_type = Value;
+	using size_type = unsigned int;
+	using const_pointer = const char*;
+private:
+	struct Slot
+	{
+		key_type key;
+		Value value;
+	};
+	static constexpr size_type c_mask = c_slots - 1;
+	static constexpr size_type c_npos = c_slots;
+	unsigned char m_tags[c_slots];//0 = empty
+	Slot m_slots[c_slots];
+	size_type m_size;
+public:
+	FixedStringMap() :m_tags(), m_slots(), m_size(0) {}
+
+	static constexpr size_type capacity() { return c_slots - c_slots / 8; }
+	size_type size()const { return m_size; }
+	bool empty()const { return m_size == 0; }
+	bool full()const { return m_size >= capacity(); }
+	void clear()
+	{
+		for (size_type i = 0; i < c_slots; i++)
+		{
+			if (m_tags[i] != 0)
+				m_slots[i] = Slot();
+			m_tags[i] = 0;
+		}
+		m_size = 0;
+	}
+
+	//Lookup - NULL if not found
+	Value* find(const_pointer key, size_type len) { return value_at(find_slot(key, len, FixedStringKernels::hash(key, len))); }
+	const Value* find(const_pointer key, size_type len)const { return const_cast<FixedStringMap*>(this)->find(key, len); }
+	Value* find(const_pointer key) { return find(key, safe_len(key)); }
+	const Value* find(const_pointer key)const { return find(key, safe_len(key)); }
+	Value* find(FixedStringView key) { return find(key.data(), key.length()); }
+	const Value* find(FixedStringView key)const { return find(key.data(), key.length()); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	Value* find(const FixedString<c_storage_size2, OverrunPolicy2>& key) { return value_at(find_slot(key.c_str(), key.length(), key.hash())); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	const Value* find(const FixedString<c_storage_size2, OverrunPolicy2>& key)const { return const_cast<FixedStringMap*>(this)->find(key); }
+
+	bool contains(const_pointer key, size_type len)const { return find(key, len) != NULL; }
+	bool contains(const_pointer key)const { return find(key) != NULL; }
+	bool contains(FixedStringView key)const { return find(key) != NULL; }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	bool contains(const FixedString<c_storage_size2, OverrunPolicy2>& key)const { return find(key) != NULL; }
+
+	//Insert or overwrite - returns the stored value, NULL if full or key too long
+	Value* insert(const_pointer key, size_type len, const Value& value)
+	{
+		Value* p = find_or_insert(key, len);
+		if (p != NULL)
+			*p = value;
+		return p;
+	}
+	Value* insert(const_pointer key, const Value& value) { return insert(key, safe_len(key), value); }
+	Value* insert(FixedStringView key, const Value& value) { return insert(key.data(), key.length(), value); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	Value* insert(const FixedString<c_storage_size2, OverrunPolicy2>& key, const Value& value) { return insert(key.c_str(), key.length(), value); }
+
+	//Existing value OR a new default constructed one - NULL if full or key too long
+	Value* find_or_insert(const_pointer key, size_type len)
+	{
+		if (key == NULL || len > key_type::capacity())
+			return NULL;
+		const auto h = FixedStringKernels::hash(key, len);
+		const auto tag = hash_tag(h);
+		auto i = static_cast<size_type>(h) & c_mask;
+		for (; m_tags[i] != 0; i = (i + 1) & c_mask)
+		{
+			if (m_tags[i] == tag && m_slots[i].key.equals(key, len))
+				return &m_slots[i].value;
+		}
+		if (full())
+			return NULL;
+		m_tags[i] = tag;
+		m_slots[i].key.assign(key, len);
+		m_size++;
+		return &m_slots[i].value;
+	}
+	Value* find_or_insert(const_pointer key) { return find_or_insert(key, safe_len(key)); }
+	Value* find_or_insert(FixedStringView key) { return find_or_insert(key.data(), key.length()); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	Value* find_or_insert(const FixedString<c_storage_size2, OverrunPolicy2>& key) { return find_or_insert(key.c_str(), key.length()); }
+
+	//Returns false if not found
+	bool erase(const_pointer key, size_type len) { return erase_slot(find_slot(key, len, FixedStringKernels::hash(key, len))); }
+	bool erase(const_pointer key) { return erase(key, safe_len(key)); }
+	bool erase(FixedStringView key) { return erase(key.data(), key.length()); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	bool erase(const FixedString<c_storage_size2, OverrunPolicy2>& key) { return erase_slot(find_slot(key.c_str(), key.length(), key.hash())); }
+
+	//fn(const key_type& key, Value& value) for every entry, in slot order
+	template<typename Fn>
+	void for_each(Fn fn)
+	{
+		for (size_type i = 0; i < c_slots; i++)
+			if (m_tags[i] != 0)
+				fn(static_cast<const key_type&>(m_slots[i].key), m_slots[i].value);
+	}
+	template<typename Fn>
+	void for_each(Fn fn)const
+	{
+		for (size_type i = 0; i < c_slots; i++)
+			if (m_tags[i] != 0)
+				fn(m_slots[i].key, m_slots[i].value);
+	}
+private:
+	static size_type safe_len(const_pointer key) { return key == NULL ? 0 : FixedStringKernels::length(key); }
+	//Top 7 bits of the hash with the high bit set so a used slot is never 0
+	static unsigned char hash_tag(size_t h) { return static_cast<unsigned char>(0x80 | (h >> (sizeof(size_t) * 8 - 7))); }
+	static size_type home_slot(const key_type& key) { return static_cast<size_type>(key.hash()) & c_mask; }
+	Value* value_at(size_type i) { return i == c_npos ? NULL : &m_slots[i].value; }
+	size_type find_slot(const_pointer key, size_type len, size_t h)const
+	{
+		if (key == NULL || len > key_type::capacity())
+			return c_npos;
+		const auto tag = hash_tag(h);
+		for (auto i = static_cast<size_type>(h) & c_mask; m_tags[i] != 0; i = (i + 1) & c_mask)
+		{
+			if (m_tags[i] == tag && m_slots[i].key.equals(key, len))
+				return i;
+		}
+		return c_npos;
+	}
+	bool erase_slot(size_type hole)
+	{
+		if (hole == c_npos)
+			return false;
+		//Shift back any following entry whose home slot is not in (hole, i]
+		for (auto i = (hole + 1) & c_mask; m_tags[i] != 0; i = (i + 1) & c_mask)
+		{
+			const auto home = home_slot(m_slots[i].key);
+			const bool stays = hole < i ? (home > hole && home <= i) : (home > hole || home <= i);
+			if (stays)
+				continue;
+			m_tags[hole] = m_tags[i];
+			m_slots[hole] = m_slots[i];
+			hole = i;
+		}
+		m_tags[hole] = 0;
+		m_slots[hole] = Slot();
+		m_size--;
+		return true;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,322 @@
+// Fixed String - multi pattern matcher (Aho-Corasick)
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGMATCHER_H
+#define _FIXEDSTRINGMATCHER_H
+#pragma once
+#include "FixedString.h"
+
+//A match of pattern id (in add() order) at [pos, pos + length)
+struct FixedStringMatch
+{
+	unsigned int pos;
+	unsigned int length;
+	unsigned int id;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringMatcher
+// Finds any of a set of patterns in one pass over the text, however many there are. The
+// tables are part of the object (see below for the size), so make a large one static:
+//		static FixedStringMatcher<> words;
+//		words.add("spam"); words.add("scam"); ...
+//		words.compile();
+//		if (words.contains(message)) ...
+//		words.find_all(message, [](const FixedStringMatch& m) { ... });
+//		words.replace(message, replacements);	//replacements[id] for each pattern
+//
+// The patterns are built into an Aho-Corasick automaton then compiled to a full transition
+// table, so each byte of text is one table lookup whatever the number of patterns. Bytes
+// are mapped to c_classes classes (the distinct bytes used by the patterns, 0 = any other)
+// to keep the table c_max_states x c_classes x 2 bytes. While no pattern is in progress the
+// bytes that cannot start one are skipped by a single lookup each.
+// ignore_case folds ASCII case in both the patterns and the text.
+// add() returns -1 if the pattern is empty, would pass c_max_states or c_classes, or the
+// matcher is already compiled.
+// indexOf() & replace() use the leftmost match, the longest if several start there, and
+// replace() does not overlap matches. find_all() reports every match, overlapping or not,
+// in order of where they end.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_max_states = 2048, unsigned int c_classes = 64>
+class FixedStringMatcher
+{
+	static_assert(c_max_states >= 2 && c_max_states <= 65535, "FixedStringMatcher states must fit 16 bits");
+	static_assert(c_classes >= 2 && c_classes <= 256, "FixedStringMatcher needs 2 to 256 byte classes");
+public:
+	using size_type = unsigned int;
+	using const_pointer = const char*;
+	using state_type = uint16_t;
+private:
+	state_type m_goto[c_max_states][c_classes];	//Trie edges (0 = none) until compiled, then every transition
+	state_type m_out[c_max_states];		//Pattern id + 1 ending at the state, 0 = none
+	state_type m_dict[c_max_states];	//Next shorter suffix state with an output, 0 = none
+	state_type m_hit[c_max_states];		//The state if it has an output, else m_dict
+	state_type m_lengths[c_max_states];	//By pattern id
+	uint8_t m_class[256];
+	bool m_start[256];	//Bytes that start a pattern
+	size_type m_states;
+	size_type m_patterns;
+	size_type m_used_classes;
+	size_type m_max_len;
+	bool m_ignore_case;
+	bool m_compiled;
+public:
+	explicit FixedStringMatcher(bool ignore_case = false) :m_states(1), m_patterns(0), m_used_classes(1), m_max_len(0), m_ignore_case(ignore_case), m_compiled(false)
+	{
+		memset(m_goto[0], 0, sizeof(m_goto[0]));
+		memset(m_class, 0, sizeof(m_class));
+		memset(m_start, 0, sizeof(m_start));
+		m_out[0] = m_dict[0] = m_hit[0] = 0;
+	}
+	FixedStringMatcher(const FixedStringMatcher&) = delete;
+	FixedStringMatcher& operator=(const FixedStringMatcher&) = delete;
+
+	size_type size()const { return m_patterns; }
+	size_type states()const { return m_states; }
+	bool compiled()const { return m_compiled; }
+
+	//Id of the pattern (an existing id if added before), -1 if it can not be added
+	int add(FixedStringView pattern)
+	{
+		if (m_compiled || pattern.empty() || pattern.length() > 0xFFFFu)
+			return -1;
+		//Check there is room first so a failed add changes nothing
+		size_type new_classes = 0;
+		bool seen[256] = {};
+		for (size_type i = 0; i < pattern.length(); i++)
+		{
+			const uint8_t b = fold(pattern[i]);
+			if (m_class[b] == 0 && !seen[b])
+			{
+				seen[b] = true;
+				new_classes++;
+			}
+		}
+		if (m_used_classes + new_classes > c_classes)
+			return -1;
+		size_type state = 0;
+		size_type depth = 0;
+		for (; depth < pattern.length() && m_goto[state][class_of(pattern[depth])] != 0; depth++)
+			state = m_goto[state][class_of(pattern[depth])];
+		if (m_states + (pattern.length() - depth) > c_max_states)
+			return -1;
+		for (size_type i = 0; i < pattern.length(); i++)
+		{
+			const uint8_t b = fold(pattern[i]);
+			if (m_class[b] == 0)
+			{
+				m_class[b] = static_cast<uint8_t>(m_used_classes++);
+				if (m_ignore_case && b >= 'a' && b <= 'z')
+					m_class[b - 0x20] = m_class[b];
+			}
+		}
+		for (; depth < pattern.length(); depth++)
+		{
+			const size_type next = m_states++;
+			memset(m_goto[next], 0, sizeof(m_goto[next]));
+			m_out[next] = 0;
+			m_goto[state][class_of(pattern[depth])] = static_cast<state_type>(next);
+			state = next;
+		}
+		if (m_out[state] != 0)
+			return m_out[state] - 1;
+		m_lengths[m_patterns] = static_cast<state_type>(pattern.length());
+		m_out[state] = static_cast<state_type>(++m_patterns);
+		if (pattern.length() > m_max_len)
+			m_max_len = pattern.length();
+		return static_cast<int>(m_patterns - 1);
+	}
+	int add(const_pointer pattern) { return add(FixedStringView(pattern)); }
+
+	//Builds the failure links (breadth first) into the full transition table, call once
+	//after the last add()
+	void compile()
+	{
+		if (m_compiled)
+			return;
+		state_type fail[c_max_states];
+		state_type queue[c_max_states];
+		size_type head = 0;
+		size_type tail = 0;
+		for (size_type c = 0; c < c_classes; c++)
+		{
+			const state_type child = m_goto[0][c];
+			if (child != 0)
+			{
+				fail[child] = 0;
+				m_dict[child] = 0;
+				queue[tail++] = child;
+			}
+		}
+		while (head < tail)
+		{
+			const state_type state = queue[head++];
+			for (size_type c = 0; c < c_classes; c++)
+			{
+				const state_type child = m_goto[state][c];
+				if (child == 0)
+				{
+					//No trie edge: go where the longest suffix goes (already complete, it is shallower)
+					m_goto[state][c] = m_goto[fail[state]][c];
+					continue;
+				}
+				const state_type link = m_goto[fail[state]][c];
+				fail[child] = link;
+				m_dict[child] = m_out[link] != 0 ? link : m_dict[link];
+				queue[tail++] = child;
+			}
+		}
+		for (size_type state = 0; state < m_states; state++)
+			m_hit[state] = m_out[state] != 0 ? static_cast<state_type>(state) : m_dict[state];
+		for (size_type b = 0; b < 256; b++)
+			m_start[b] = m_goto[0][m_class[b]] != 0;
+		m_compiled = true;
+	}
+
+	//Search - the matcher must be compiled
+	bool contains(FixedStringView text)const
+	{
+		bool found = false;
+		scan(text, [&found](size_type, state_type) { found = true; return false; });
+		return found;
+	}
+	//Position of the leftmost (then longest) match, -1 if none
+	int indexOf(FixedStringView text, FixedStringMatch* match = NULL)const
+	{
+		FixedStringMatch m;
+		if (!next_match(text, 0, m))
+			return -1;
+		if (match != NULL)
+			*match = m;
+		return static_cast<int>(m.pos);
+	}
+	//fn(const FixedStringMatch&) for every match, returns the count
+	template<typename Fn>
+	size_type find_all(FixedStringView text, Fn fn)const
+	{
+		size_type count = 0;
+		scan(text, [&](size_type end, state_type hit) {
+			for (; hit != 0; hit = m_dict[hit], count++)
+				fn(match_at(end, hit));
+			return true;
+		});
+		return count;
+	}
+	//Replaces each match of pattern id with replacements[id] in one pass, returns false if the
+	//result was truncated (it is cut at the capacity as FixedString::replace)
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	bool replace(FixedString<c_storage_size, OverrunPolicy>& s, const FixedStringView* replacements)const
+	{
+		bool complete = true;
+		handle_replace(s, replacements, complete);
+		return complete;
+	}
+	//As replace(), returns the number of matches - all of them, even past a cut off result
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_type replace_all(FixedString<c_storage_size, OverrunPolicy>& s, const FixedStringView* replacements)const
+	{
+		bool complete = true;
+		return handle_replace(s, replacements, complete);
+	}
+private:
+	uint8_t fold(char c)const
+	{
+		const uint8_t b = static_cast<uint8_t>(c);
+		return m_ignore_case && b >= 'A' && b <= 'Z' ? static_cast<uint8_t>(b | 0x20) : b;
+	}
+	size_type class_of(char c)const { return m_class[static_cast<uint8_t>(c)]; }
+	FixedStringMatch match_at(size_type end, state_type hit)const
+	{
+		const size_type id = m_out[hit] - 1u;
+		FixedStringMatch m = { end - m_lengths[id], m_lengths[id], id };
+		return m;
+	}
+	//Index of the next byte at or after i that can start a pattern, len if none
+	size_type skip(const_pointer data, size_type i, size_type len)const
+	{
+		while (i < len && !m_start[static_cast<uint8_t>(data[i])])
+			i++;
+		return i;
+	}
+	//Runs the automaton, fn(end, hit state) for each position a pattern ends, false stops
+	template<typename Fn>
+	void scan(FixedStringView text, Fn fn)const
+	{
+		const_pointer data = text.data();
+		const size_type len = text.length();
+		size_type state = 0;
+		for (size_type i = 0; i < len; i++)
+		{
+			if (state == 0 && (i = skip(data, i, len)) == len)
+				return;
+			state = m_goto[state][class_of(data[i])];
+			if (m_hit[state] != 0 && !fn(i + 1, m_hit[state]))
+				return;
+		}
+	}
+	//Leftmost then longest match starting at or after from. A match starting no later than the
+	//best so far ends within m_max_len of its start, and none can once back at the root.
+	bool next_match(FixedStringView text, size_type from, FixedStringMatch& best)const
+	{
+		const_pointer data = text.data();
+		size_type len = text.length();
+		bool found = false;
+		size_type state = 0;
+		for (size_type i = from; i < len; i++)
+		{
+			if (state == 0 && (found || (i = skip(data, i, len)) == len))
+				break;
+			state = m_goto[state][class_of(data[i])];
+			for (state_type hit = m_hit[state]; hit != 0; hit = m_dict[hit])
+			{
+				const FixedStringMatch m = match_at(i + 1, hit);
+				if (!found || m.pos < best.pos || (m.pos == best.pos && m.length > best.length))
+				{
+					best = m;
+					if (best.pos + m_max_len < len)
+						len = best.pos + m_max_len;
+				}
+				found = true;
+			}
+		}
+		return found;
+	}
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_type handle_replace(FixedString<c_storage_size, OverrunPolicy>& s, const FixedStringView* replacements, bool& complete)const
+	{
+		FixedStringMatch m;
+		size_type from = 0;
+		size_type count = 0;
+		FixedString<c_storage_size, OverrunPolicy> result;
+		for (; next_match(s, from, m); count++)
+		{
+			//Once cut short the rest are only counted, as FixedString::replace_all()
+			if (complete)
+				complete = result.concat(s.c_str() + from, m.pos - from) && result.concat(replacements[m.id]);
+			from = m.pos + m.length;
+		}
+		if (count == 0)
+			return 0;
+		if (complete)
+			complete = result.concat(s.c_str() + from, s.length() - from);
+		s = result;
+		return count;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
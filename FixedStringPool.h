@@ -0,0 +1,183 @@
+// Fixed String - interning pool of FixedStrings with dense integer ids
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGPOOL_H
+#define _FIXEDSTRINGPOOL_H
+#pragma once
+#include "FixedString.h"
+
+#ifndef ARDUINO
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringPool (non-Arduino)
+// Interns up to c_capacity distinct strings, each gets a stable 32 bit id (0, 1, 2...) so
+// equality is an integer compare and only one copy of each string is held, in the pool's
+// own arrays (so make a large one static):
+//		static FixedStringPool<16, 4096> symbols;
+//		const auto id = symbols.intern("AAPL");	//Same id for every later "AAPL"
+//		symbols[id] == "AAPL"
+//
+// With c_ignore_case ids are ASCII case insensitive (equalsIgnoreCase), the first
+// spelling interned is the one kept.
+// Thread safe: lookups (find, the hit path of intern, operator[]) are lock free. The hash
+// table is split into c_shards shards by hash and adding a new string only locks its own
+// shard, so inserts of different strings rarely contend. A string is fully written before
+// its id is published.
+// intern()/find() return npos if the string is longer than the key capacity, not found
+// (find) or the pool (or its shard, at 7/8 full) is full.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_key_size, unsigned int c_capacity = 4096, bool c_ignore_case = false, unsigned int c_shards = 16>
+class FixedStringPool
+{
+	static_assert(c_shards > 0 && (c_shards & (c_shards - 1)) == 0, "FixedStringPool shard count must be a power of 2");
+public:
+	using key_type = FixedString<c_key_size>;
+	using id_type = uint32_t;
+	using size_type = unsigned int;
+	using const_pointer = const char*;
+	static constexpr id_type npos = 0xFFFFFFFFu;
+private:
+	//Twice the capacity over all the shards, at least 16 per shard
+	static constexpr size_type shard_slots(size_type n = 16) { return n * c_shards >= 2 * c_capacity ? n : shard_slots(n * 2); }
+	static constexpr size_type c_slots = shard_slots();
+	static constexpr size_type c_mask = c_slots - 1;
+	static constexpr size_type c_shard_capacity = c_slots - c_slots / 8;
+
+	struct Shard
+	{
+		std::atomic<id_type> slots[c_slots];//id + 1, 0 = empty
+		size_type size = 0;
+		std::mutex lock;
+		Shard() { for (auto& slot : slots) slot.store(0, std::memory_order_relaxed); }
+	};
+	key_type m_strings[c_capacity];
+	uint32_t m_hashes[c_capacity];
+	Shard m_shards[c_shards];
+	std::atomic<id_type> m_next{ 0 };
+	const key_type m_empty;		//For an id not handed out
+public:
+	FixedStringPool() = default;
+	FixedStringPool(const FixedStringPool&) = delete;
+	FixedStringPool& operator=(const FixedStringPool&) = delete;
+
+	static constexpr size_type capacity() { return c_capacity; }
+	//Ids handed out so far - a racing intern() may still be publishing the newest
+	size_type size()const { return m_next.load(std::memory_order_acquire); }
+	bool empty()const { return size() == 0; }
+
+	//Id of s, adding it if new
+	id_type intern(const_pointer s, size_type len)
+	{
+		if (s == NULL || len > key_type::capacity())
+			return npos;
+		const auto h = hash_of(s, len);
+		Shard& shard = m_shards[shard_of(h)];
+		size_type i = 0;
+		const id_type id = probe(shard, s, len, h, i);
+		if (id != npos)
+			return id;
+		std::lock_guard<std::mutex> guard(shard.lock);
+		//Another thread may have added it (or a different string in slot i) since the probe
+		const id_type added = probe(shard, s, len, h, i);
+		if (added != npos || shard.size >= c_shard_capacity)
+			return added;
+		const id_type new_id = claim_id();
+		if (new_id == npos)
+			return npos;
+		m_strings[new_id].assign(s, len);
+		m_hashes[new_id] = h;
+		shard.size++;
+		shard.slots[i].store(new_id + 1, std::memory_order_release);
+		return new_id;
+	}
+	id_type intern(const_pointer s) { return intern(s, safe_len(s)); }
+	id_type intern(FixedStringView s) { return intern(s.data(), s.length()); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	id_type intern(const FixedString<c_storage_size2, OverrunPolicy2>& s) { return intern(s.c_str(), s.length()); }
+
+	//Id of s if already interned, else npos
+	id_type find(const_pointer s, size_type len)const
+	{
+		if (s == NULL || len > key_type::capacity())
+			return npos;
+		const auto h = hash_of(s, len);
+		size_type i = 0;
+		return probe(m_shards[shard_of(h)], s, len, h, i);
+	}
+	id_type find(const_pointer s)const { return find(s, safe_len(s)); }
+	id_type find(FixedStringView s)const { return find(s.data(), s.length()); }
+	template<unsigned int c_storage_size2, typename OverrunPolicy2>
+	id_type find(const FixedString<c_storage_size2, OverrunPolicy2>& s)const { return find(s.c_str(), s.length()); }
+	bool contains(FixedStringView s)const { return find(s) != npos; }
+
+	//The string for an id returned by intern()/find(), empty for npos or an id not handed out
+	const key_type& operator[](id_type id)const { return id < size() ? m_strings[id] : m_empty; }
+	FixedStringView view(id_type id)const { return (*this)[id]; }
+
+	//Ordering of two ids by their strings (compareTo or compareToIgnoreCase), equal ids are 0
+	int compare(id_type lhs, id_type rhs)const
+	{
+		if (lhs == rhs)
+			return 0;
+		return c_ignore_case ? (*this)[lhs].compareToIgnoreCase((*this)[rhs]) : (*this)[lhs].compareTo((*this)[rhs]);
+	}
+private:
+	static size_type safe_len(const_pointer s) { return s == NULL ? 0 : FixedStringKernels::length(s); }
+	static size_type shard_of(uint32_t h) { return (h >> 24) & (c_shards - 1); }
+	static uint32_t hash_of(const_pointer s, size_type len)
+	{
+		if (!c_ignore_case)
+			return static_cast<uint32_t>(FixedStringKernels::hash(s, len));
+		char folded[key_type::capacity() + 1];
+		for (size_type i = 0; i < len; i++)
+			folded[i] = (s[i] >= 'A' && s[i] <= 'Z') ? static_cast<char>(s[i] | 0x20) : s[i];
+		return static_cast<uint32_t>(FixedStringKernels::hash(folded, len));
+	}
+	bool matches(id_type id, const_pointer s, size_type len, uint32_t h)const
+	{
+		if (m_hashes[id] != h)
+			return false;
+		return c_ignore_case ? m_strings[id].equalsIgnoreCase(FixedStringView(s, len)) : m_strings[id].equals(s, len);
+	}
+	//Id of s in the shard or npos with i at the empty slot that ended the search
+	id_type probe(const Shard& shard, const_pointer s, size_type len, uint32_t h, size_type& i)const
+	{
+		for (i = h & c_mask;; i = (i + 1) & c_mask)
+		{
+			const id_type slot = shard.slots[i].load(std::memory_order_acquire);
+			if (slot == 0)
+				return npos;
+			if (matches(slot - 1, s, len, h))
+				return slot - 1;
+		}
+	}
+	id_type claim_id()
+	{
+		id_type id = m_next.load(std::memory_order_relaxed);
+		while (id < c_capacity)
+		{
+			if (m_next.compare_exchange_weak(id, id + 1, std::memory_order_acq_rel))
+				return id;
+		}
+		return npos;
+	}
+};
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,266 @@
+// Fixed String - capacity profiling
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGPROFILE_H
+#define _FIXEDSTRINGPROFILE_H
+#pragma once
+
+#ifndef ARDUINO
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringProfile (non-Arduino)
+// Measures how full each size of FixedString gets so capacities can be set from data. Build
+// with FIXEDSTRING_PROFILE defined (before including FixedString.h, for the whole program)
+// and every FixedString<N> records, for its N:
+//		- the lengths it is set to (not clears) as a power of 2 histogram and the high-water mark
+//		- the truncations (each call the overrun policy is told of)
+//		- the same counts by call site tag, from the innermost FIXEDSTRING_PROFILE_TAG in scope
+//			void on_order(const Msg& m)
+//			{
+//				FIXEDSTRING_PROFILE_TAG("on_order");
+//				...
+//			}
+// The report goes to stderr at exit (see report_at_exit()) or on demand:
+//		FixedStringProfile::report(stdout);
+// "fits" is the smallest FixedString<N> that would have held the high-water mark and "saved"
+// the bytes that would save on each string.
+// Counting is lock free (relaxed atomics), copies of a string are not counted. Without
+// FIXEDSTRING_PROFILE nothing is recorded and FixedString is unchanged.
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringProfile
+{
+public:
+	//Histogram bucket b counts lengths in [2^(b-1), 2^b), bucket 0 is length 0
+	static constexpr unsigned int c_buckets = 33;
+	//Tags tracked per size, the rest are counted as "(other)"
+	static constexpr unsigned int c_tags = 8;
+
+	struct Counts
+	{
+		std::atomic<uint64_t> sets{ 0 };
+		std::atomic<uint64_t> truncations{ 0 };
+		std::atomic<uint32_t> max_len{ 0 };
+	};
+	struct TagCounts : Counts
+	{
+		std::atomic<const char*> tag{ nullptr };
+	};
+	struct Stats : Counts
+	{
+		const unsigned int storage_size;
+		const unsigned int capacity;
+		std::atomic<uint64_t> histogram[c_buckets] = {};
+		TagCounts tags[c_tags];
+		Counts other_tags;
+		Stats* next;
+
+		Stats(unsigned int storage, unsigned int cap) :storage_size(storage), capacity(cap), next(nullptr)
+		{
+			add(this);
+		}
+		void set_len(unsigned int len)
+		{
+			histogram[bucket(len)].fetch_add(1, std::memory_order_relaxed);
+			count_len(*this, len);
+			if (Counts* t = tag_counts())
+				count_len(*t, len);
+		}
+		void truncated()
+		{
+			truncations.fetch_add(1, std::memory_order_relaxed);
+			if (Counts* t = tag_counts())
+				t->truncations.fetch_add(1, std::memory_order_relaxed);
+		}
+	private:
+		static void count_len(Counts& c, unsigned int len)
+		{
+			c.sets.fetch_add(1, std::memory_order_relaxed);
+			uint32_t max = c.max_len.load(std::memory_order_relaxed);
+			while (len > max && !c.max_len.compare_exchange_weak(max, len, std::memory_order_relaxed))
+				;
+		}
+		//The counts for the current tag, NULL if none
+		Counts* tag_counts()
+		{
+			const char* tag = current_tag();
+			if (tag == nullptr)
+				return nullptr;
+			for (auto& t : tags)
+			{
+				const char* held = t.tag.load(std::memory_order_acquire);
+				if (held == nullptr && t.tag.compare_exchange_strong(held, tag, std::memory_order_acq_rel))
+					return &t;
+				if (held == tag)
+					return &t;
+			}
+			return &other_tags;
+		}
+	};
+
+	//Sets the call site tag for the current thread while in scope, see FIXEDSTRING_PROFILE_TAG.
+	//The tag must be a string literal (or outlive the report), it is compared by address.
+	class Tag
+	{
+		const char* m_prev;
+	public:
+		explicit Tag(const char* tag) :m_prev(current_tag()) { current_tag() = tag; }
+		~Tag() { current_tag() = m_prev; }
+		Tag(const Tag&) = delete;
+		Tag& operator=(const Tag&) = delete;
+	};
+
+	//The counts for FixedString<c_storage_size>, created on first use
+	template<unsigned int c_storage_size>
+	static Stats& stats(unsigned int capacity)
+	{
+		static Stats s(c_storage_size, capacity);
+		return s;
+	}
+	static unsigned int bucket(unsigned int len)
+	{
+		return len == 0 ? 0u : 32u - static_cast<unsigned int>(__builtin_clz(len));
+	}
+	//The storage size a string needs to hold len chars (see FixedStringLength)
+	static unsigned int fits(unsigned int len)
+	{
+		const unsigned int byte_len = (len + 1 + 1 + 3) & ~3u;
+		if (byte_len <= 0x100u)
+			return byte_len < 4 ? 4u : byte_len;
+		const unsigned int short_len = (len + 2 + 1 + 3) & ~3u;
+		return short_len <= 0x10000u ? short_len : (len + 4 + 1 + 3) & ~3u;
+	}
+
+	//Writes the report, by storage size
+	static void report(FILE* out = stderr)
+	{
+		fprintf(out, "FixedString profile\n%8s %8s %14s %10s %8s %8s %8s\n", "size", "capacity", "sets", "truncated", "max_len", "fits", "saved");
+		for (const Stats* s = next_larger(0); s != nullptr; s = next_larger(s->storage_size))
+		{
+			if (s->sets.load(std::memory_order_relaxed) == 0 && s->truncations.load(std::memory_order_relaxed) == 0)
+				continue;
+			const unsigned int max_len = s->max_len.load(std::memory_order_relaxed);
+			const unsigned int fit = s->truncations.load(std::memory_order_relaxed) != 0 ? 0u : fits(max_len);
+			fprintf(out, "%8u %8u %14llu %10llu %8u ", s->storage_size, s->capacity,
+				static_cast<unsigned long long>(s->sets.load(std::memory_order_relaxed)),
+				static_cast<unsigned long long>(s->truncations.load(std::memory_order_relaxed)), max_len);
+			if (fit == 0)
+				fprintf(out, "%8s %8s\n", "-", "-");	//Truncated: the high-water mark is the capacity
+			else
+				fprintf(out, "%8u %8d\n", fit, static_cast<int>(s->storage_size) - static_cast<int>(fit));
+			fprintf(out, "%8s lengths", "");
+			for (unsigned int b = 0; b < c_buckets; b++)
+			{
+				const uint64_t n = s->histogram[b].load(std::memory_order_relaxed);
+				if (n != 0)
+					fprintf(out, " <%llu:%llu", b == 0 ? 1ull : 1ull << b, static_cast<unsigned long long>(n));
+			}
+			fprintf(out, "\n");
+			for (const TagCounts& t : s->tags)
+			{
+				if (const char* tag = t.tag.load(std::memory_order_acquire))
+					report_tag(out, tag, t);
+			}
+			if (s->other_tags.sets.load(std::memory_order_relaxed) != 0 || s->other_tags.truncations.load(std::memory_order_relaxed) != 0)
+				report_tag(out, "(other)", s->other_tags);
+		}
+	}
+	//Zeroes every count
+	static void reset()
+	{
+		for (Stats* s = head().load(std::memory_order_acquire); s != nullptr; s = s->next)
+		{
+			zero(*s);
+			for (auto& h : s->histogram)
+				h.store(0, std::memory_order_relaxed);
+			for (auto& t : s->tags)
+				zero(t);
+			zero(s->other_tags);
+		}
+	}
+	//Whether report() is written to stderr at exit, the default
+	static void report_at_exit(bool on) { exit_report().store(on, std::memory_order_relaxed); }
+
+	static const char*& current_tag()
+	{
+		static thread_local const char* tag = nullptr;
+		return tag;
+	}
+private:
+	static std::atomic<Stats*>& head()
+	{
+		static std::atomic<Stats*> h{ nullptr };
+		return h;
+	}
+	static std::atomic<bool>& exit_report()
+	{
+		static std::atomic<bool> on{ true };
+		return on;
+	}
+	static void add(Stats* s)
+	{
+		Stats* first = head().load(std::memory_order_relaxed);
+		do
+			s->next = first;
+		while (!head().compare_exchange_weak(first, s, std::memory_order_release, std::memory_order_relaxed));
+		if (first == nullptr)
+			atexit([] {
+				if (exit_report().load(std::memory_order_relaxed))
+					report(stderr);
+			});
+	}
+	//The stats of the smallest size above storage_size, NULL if none - there are only a few sizes
+	static const Stats* next_larger(unsigned int storage_size)
+	{
+		const Stats* found = nullptr;
+		for (const Stats* s = head().load(std::memory_order_acquire); s != nullptr; s = s->next)
+		{
+			if (s->storage_size > storage_size && (found == nullptr || s->storage_size < found->storage_size))
+				found = s;
+		}
+		return found;
+	}
+	static void zero(Counts& c)
+	{
+		c.sets.store(0, std::memory_order_relaxed);
+		c.truncations.store(0, std::memory_order_relaxed);
+		c.max_len.store(0, std::memory_order_relaxed);
+	}
+	static void report_tag(FILE* out, const char* tag, const Counts& c)
+	{
+		fprintf(out, "%8s tag %-20s %10llu %10llu %8u\n", "", tag,
+			static_cast<unsigned long long>(c.sets.load(std::memory_order_relaxed)),
+			static_cast<unsigned long long>(c.truncations.load(std::memory_order_relaxed)),
+			static_cast<unsigned int>(c.max_len.load(std::memory_order_relaxed)));
+	}
+};
+
+#define FIXEDSTRING_PROFILE_CAT2(a, b) a##b
+#define FIXEDSTRING_PROFILE_CAT(a, b) FIXEDSTRING_PROFILE_CAT2(a, b)
+#ifdef FIXEDSTRING_PROFILE
+#define FIXEDSTRING_PROFILE_TAG(tag) FixedStringProfile::Tag FIXEDSTRING_PROFILE_CAT(fixedstring_profile_tag_, __LINE__)(tag)
+#endif
+
+#endif
+#ifndef FIXEDSTRING_PROFILE_TAG
+#define FIXEDSTRING_PROFILE_TAG(tag)
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,245 @@
+// Fixed String - lock free queue of FixedString records
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGQUEUE_H
+#define _FIXEDSTRINGQUEUE_H
+#pragma once
+#include "FixedString.h"
+
+#ifndef ARDUINO
+#include <atomic>
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringQueue (non-Arduino, POSIX)
+// Bounded lock free ring of c_slots FixedString<c_record_size> records for handing log
+// lines (or any text) from hot threads to one consumer - no heap, no locks, no copies:
+//		static FixedStringQueue<256, 4096> log;	//Multi producer, single consumer
+//		//Producers
+//		log.fmt("{} filled {} @ {}", symbol, qty, price);
+//		if (auto* rec = log.reserve()) { rec->format("%s %d", name, n); log.commit(rec); }
+//		//Consumer (e.g. an I/O thread)
+//		while (running) log.write_to(fd);
+//
+// A producer reserves the next slot, writes the text straight into its record and commits
+// it. The slots carry a sequence number (Vyukov's bounded queue) so producers only contend on
+// the tail when c_multi_producer, c_multi_producer = false is for a single producer (SPSC).
+// Records are consumed in reserve() order, a reserved but uncommitted record holds back the
+// ones after it. When full reserve() returns NULL and push()/fmt() false, see dropped().
+// write_to() gathers up to c_write_batch committed records (each followed by delim) into
+// one writev(), a partial write resumes where it stopped on the next call.
+// front()/pop(), drain() & write_to() are for a single consumer thread.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_record_size = 256, unsigned int c_slots = 1024, bool c_multi_producer = true>
+class FixedStringQueue
+{
+	static_assert(c_slots >= 2 && (c_slots & (c_slots - 1)) == 0, "FixedStringQueue slot count must be a power of 2");
+public:
+	using record_type = FixedString<c_record_size>;
+	using size_type = unsigned int;
+	using char_type = char;
+	//Records per writev(), each is the text and the delimiter
+	static constexpr size_type c_write_batch = IOV_MAX / 2 < 512 ? IOV_MAX / 2 : 512;
+private:
+	static constexpr size_type c_mask = c_slots - 1;
+	//Producers and the consumer write different lines
+	struct alignas(64) Sequence
+	{
+		std::atomic<size_t> value;
+	};
+	struct alignas(64) Counter
+	{
+		std::atomic<size_t> value{ 0 };
+	};
+	record_type m_records[c_slots];
+	Sequence m_seqs[c_slots];	//pos = free for the producer at pos, pos + 1 = committed
+	Counter m_tail;				//Next position to reserve
+	Counter m_head;				//Next position to consume, only written by the consumer
+	Counter m_dropped;
+	size_type m_written = 0;	//Bytes of the head record already written by write_to()
+	char_type m_delim = '\n';	//The head record's delimiter
+public:
+	FixedStringQueue()
+	{
+		for (size_type i = 0; i < c_slots; i++)
+			m_seqs[i].value.store(i, std::memory_order_relaxed);
+	}
+	FixedStringQueue(const FixedStringQueue&) = delete;
+	FixedStringQueue& operator=(const FixedStringQueue&) = delete;
+
+	static constexpr size_type capacity() { return c_slots; }
+	//Records reserved and not yet consumed - only a snapshot while producers are running
+	size_type size()const
+	{
+		return static_cast<size_type>(m_tail.value.load(std::memory_order_acquire) - m_head.value.load(std::memory_order_acquire));
+	}
+	bool empty()const { return size() == 0; }
+	//Records refused because the queue was full
+	size_t dropped()const { return m_dropped.value.load(std::memory_order_relaxed); }
+
+	//Producer
+	//The next record to write, NULL if full. It still holds an old text so assign or format it,
+	//then commit() it.
+	record_type* reserve()
+	{
+		size_t pos = m_tail.value.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			const size_type slot = pos & c_mask;
+			const size_t seq = m_seqs[slot].value.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(seq - pos);
+			if (diff == 0)
+			{
+				if (!c_multi_producer)
+				{
+					m_tail.value.store(pos + 1, std::memory_order_relaxed);
+					return &m_records[slot];
+				}
+				if (m_tail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					return &m_records[slot];
+			}
+			else if (diff < 0)
+			{
+				//The consumer has not freed this slot from the last time round
+				m_dropped.value.fetch_add(1, std::memory_order_relaxed);
+				return NULL;
+			}
+			else
+				pos = m_tail.value.load(std::memory_order_relaxed);
+		}
+	}
+	//Publishes a record from reserve()
+	void commit(record_type* record)
+	{
+		Sequence& seq = m_seqs[record - m_records];
+		seq.value.store(seq.value.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	//Returns false if full or truncated (a truncated record is still queued)
+	bool push(FixedStringView text)
+	{
+		record_type* record = reserve();
+		if (record == NULL)
+			return false;
+		const bool ok = record->assign(text);
+		commit(record);
+		return ok;
+	}
+	//{} style format straight into a record, see FixedStringFormat
+	template<typename... Args>
+	bool fmt(FixedStringFormat<typename FixedStringIdentity<Args>::type...> f, const Args&... args)
+	{
+		record_type* record = reserve();
+		if (record == NULL)
+			return false;
+		const bool ok = record->fmt(f, args...);
+		commit(record);
+		return ok;
+	}
+
+	//Consumer
+	//The next committed record, NULL if none
+	const record_type* front()const { return peek(0); }
+	void pop()
+	{
+		if (front() != NULL)
+			release();
+	}
+	//fn(const record_type&) for up to max committed records in order, returns the count
+	template<typename Fn>
+	size_type drain(Fn fn, size_type max = c_slots)
+	{
+		size_type n = 0;
+		for (const record_type* record; n < max && (record = front()) != NULL; n++)
+		{
+			fn(*record);
+			release();
+		}
+		return n;
+	}
+	//Writes up to max committed records to fd with one writev(), each followed by delim (none
+	//if 0) - a record part written by an earlier call keeps that call's delim. Returns the bytes
+	//written, 0 if there was nothing to write or -1 (see errno).
+	//Records are only freed once wholly written.
+	ssize_t write_to(int fd, char_type delim = '\n', size_type max = c_write_batch)
+	{
+		if (max > c_write_batch)
+			max = c_write_batch;
+		if (m_written == 0)
+			m_delim = delim;
+		iovec iov[2 * c_write_batch];
+		int cnt = 0;
+		size_type n = 0;
+		for (const record_type* record; n < max && (record = peek(n)) != NULL; n++)
+		{
+			const size_type skip = n == 0 ? m_written : 0;
+			char_type* record_delim = n == 0 ? &m_delim : &delim;
+			if (skip < record->length())
+				iov[cnt++] = iovec{ const_cast<char_type*>(record->c_str()) + skip, record->length() - skip };
+			if (*record_delim != 0)
+				iov[cnt++] = iovec{ record_delim, 1 };
+		}
+		if (cnt == 0)
+		{
+			//Empty records with no delimiter
+			while (n-- > 0)
+				release();
+			return 0;
+		}
+		ssize_t written;
+		do
+			written = writev(fd, iov, cnt);
+		while (written < 0 && errno == EINTR);
+		if (written < 0)
+			return written;
+		//Free the records wholly written, an empty record with no delimiter has no bytes
+		size_t left = static_cast<size_t>(written);
+		for (const record_type* record; (record = front()) != NULL; release())
+		{
+			const size_t rest = record->length() + (m_delim != 0 ? 1u : 0u) - m_written;
+			if (left < rest)
+			{
+				m_written += static_cast<size_type>(left);
+				break;
+			}
+			left -= rest;
+			m_delim = delim;
+		}
+		return written;
+	}
+private:
+	//The record n after the head if committed
+	const record_type* peek(size_type n)const
+	{
+		const size_t pos = m_head.value.load(std::memory_order_relaxed) + n;
+		const size_type slot = pos & c_mask;
+		return m_seqs[slot].value.load(std::memory_order_acquire) == pos + 1 ? &m_records[slot] : NULL;
+	}
+	//Frees the head record for the producers
+	void release()
+	{
+		const size_t pos = m_head.value.load(std::memory_order_relaxed);
+		m_seqs[pos & c_mask].value.store(pos + c_slots, std::memory_order_release);
+		m_head.value.store(pos + 1, std::memory_order_release);
+		m_written = 0;
+	}
+};
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,257 @@
+// Fixed String - line reader filling FixedStrings from a file
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGREADER_H
+#define _FIXEDSTRINGREADER_H
+#pragma once
+#include "FixedString.h"
+
+#ifndef ARDUINO
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringReader (non-Arduino, POSIX)
+// Reads a file (or fd) a line at a time as FixedStrings or zero copy FixedStringViews:
+//		FixedStringReader<> in("replay.log");
+//		FixedString<128> line;
+//		while (in.next(line)) ...
+//		FixedString<128> batch[256];
+//		while (size_t n = in.read(batch, 256)) ...
+//
+// A regular file of c_map_min (1MB) or more is memory mapped, anything else (a small file,
+// pipe, socket or a file that will not map) is read in c_buffer_size blocks into the reader.
+// The '\n' and any '\r' before it are not part of the line, a last line with no '\n' is
+// still returned.
+// Lines longer than a FixedString are truncated the same as assign() (the overrun policy is
+// told). When block reading, a line longer than the buffer is returned cut to the buffer
+// size and the rest of it skipped - see overlong().
+// Views are valid until close() when mapped(), else until the next read.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_buffer_size = 65536>
+class FixedStringReader
+{
+public:
+	using size_type = size_t;
+	using const_pointer = const char*;
+	//Smaller files are read, mapping costs more than it saves
+	static constexpr off_t c_map_min = 1 << 20;
+private:
+	const_pointer m_pos;	//Unread data [m_pos, m_end) in the mapping or buffer
+	const_pointer m_end;
+	void* m_map;
+	size_type m_map_size;
+	int m_fd;
+	bool m_own_fd;
+	bool m_eof;
+	bool m_skip;	//Skipping the rest of an overlong line
+	bool m_skip_cr;	//The cut line ended in '\r', it was whole if '\n' is next
+	unsigned long m_overlong;
+	char m_buffer[c_buffer_size];
+public:
+	FixedStringReader() :m_pos(NULL), m_end(NULL), m_map(NULL), m_map_size(0), m_fd(-1), m_own_fd(false), m_eof(true), m_skip(false), m_skip_cr(false), m_overlong(0) {}
+	explicit FixedStringReader(const_pointer path) :FixedStringReader() { open(path); }
+	~FixedStringReader() { close(); }
+	FixedStringReader(const FixedStringReader&) = delete;
+	FixedStringReader& operator=(const FixedStringReader&) = delete;
+
+	bool open(const_pointer path)
+	{
+		close();
+		const int fd = ::open(path, O_RDONLY);
+		if (fd < 0)
+			return false;
+		m_own_fd = true;
+		return attach(fd);
+	}
+	//fd is not closed by the reader
+	bool open(int fd)
+	{
+		close();
+		return fd >= 0 && attach(fd);
+	}
+	void close()
+	{
+		if (m_map != NULL)
+			munmap(m_map, m_map_size);
+		if (m_own_fd)
+			::close(m_fd);
+		m_pos = m_end = NULL;
+		m_map = NULL;
+		m_map_size = 0;
+		m_fd = -1;
+		m_own_fd = false;
+		m_eof = true;
+		m_skip = false;
+		m_skip_cr = false;
+	}
+	bool is_open()const { return m_fd >= 0; }
+	bool mapped()const { return m_map != NULL; }
+	//Lines cut to the buffer size when block reading (one cut after a '\r' is counted once the
+	//next byte is read, as it is not overlong if that is the '\n')
+	unsigned long overlong()const { return m_overlong; }
+
+	//Next line, false at the end
+	bool next(FixedStringView& line) { return next_line(line, true); }
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	bool next(FixedString<c_storage_size, OverrunPolicy>& line)
+	{
+		static_assert(FixedString<c_storage_size, OverrunPolicy>::capacity() < c_buffer_size, "FixedStringReader buffer must be larger than the string");
+		FixedStringView view;
+		if (!next_line(view, true))
+			return false;
+		line.assign(view);
+		return true;
+	}
+
+	//Batches - fills up to max lines, 0 at the end
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_type read(FixedString<c_storage_size, OverrunPolicy>* lines, size_type max)
+	{
+		size_type n = 0;
+		while (n < max && next(lines[n]))
+			n++;
+		return n;
+	}
+	//When block reading stops early rather than reuse the buffer under the views already returned
+	size_type read(FixedStringView* lines, size_type max)
+	{
+		size_type n = 0;
+		while (n < max && next_line(lines[n], n == 0))
+			n++;
+		return n;
+	}
+private:
+	bool attach(int fd)
+	{
+		m_fd = fd;
+		m_eof = false;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= c_map_min)
+		{
+			void* map = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map != MAP_FAILED)
+			{
+				madvise(map, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+				m_map = map;
+				m_map_size = static_cast<size_t>(st.st_size);
+				m_pos = static_cast<const_pointer>(map);
+				m_end = m_pos + m_map_size;
+				m_eof = true;
+				return true;
+			}
+		}
+		m_pos = m_end = m_buffer;
+		return true;
+	}
+	//Keeps the unread data and reads more after it, false if nothing more was read
+	bool fill()
+	{
+		const size_type kept = static_cast<size_type>(m_end - m_pos);
+		memmove(m_buffer, m_pos, kept);
+		m_pos = m_buffer;
+		m_end = m_buffer + kept;
+		for (;;)
+		{
+			const ssize_t got = ::read(m_fd, m_buffer + kept, c_buffer_size - kept);
+			if (got > 0)
+			{
+				m_end += got;
+				return true;
+			}
+			if (got < 0 && errno == EINTR)
+				continue;
+			m_eof = true;
+			return false;
+		}
+	}
+	static FixedStringView make_line(const_pointer begin, const_pointer end)
+	{
+		if (end > begin && end[-1] == '\r')
+			end--;
+		return FixedStringView(begin, static_cast<FixedStringView::size_type>(end - begin));
+	}
+	bool next_line(FixedStringView& line, bool refill)
+	{
+		if (m_pos == NULL)
+			return false;
+		for (;;)
+		{
+			const_pointer nl = FixedStringKernels::find_char(m_pos, static_cast<size_type>(m_end - m_pos), '\n');
+			if (m_skip_cr)
+			{
+				if (m_pos == m_end)
+				{
+					if (m_eof || !refill || !fill())
+						return false;
+					continue;
+				}
+				m_skip_cr = false;
+				if (*m_pos == '\n')
+				{
+					m_pos++;
+					m_skip = false;
+					continue;
+				}
+				m_overlong++;
+			}
+			if (m_skip)
+			{
+				m_pos = nl == NULL ? m_end : nl + 1;
+				m_skip = nl == NULL;
+				if (m_skip && (m_eof || !refill || !fill()))
+					return false;
+				continue;
+			}
+			if (nl != NULL)
+			{
+				line = make_line(m_pos, nl);
+				m_pos = nl + 1;
+				return true;
+			}
+			if (m_eof)
+			{
+				if (m_pos == m_end)
+					return false;
+				line = make_line(m_pos, m_end);
+				m_pos = m_end;
+				return true;
+			}
+			if (m_pos == m_buffer && m_end == m_buffer + c_buffer_size)
+			{
+				//No '\n' in a full buffer
+				line = make_line(m_buffer, m_end);
+				m_pos = m_end;
+				m_skip = true;
+				m_skip_cr = m_end[-1] == '\r';
+				if (!m_skip_cr)
+					m_overlong++;
+				return true;
+			}
+			if (!refill)
+				return false;
+			fill();
+		}
+	}
+};
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
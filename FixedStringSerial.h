@@ -0,0 +1,256 @@
+// Fixed String - binary serialization of FixedStrings
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGSERIAL_H
+#define _FIXEDSTRINGSERIAL_H
+#pragma once
+#include "FixedString.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringSerialWriter / FixedStringSerialReader
+// Pack strings into a buffer and back in the binary format of FixedString::serialize() - each
+// record is the length as a varint then the text, so nothing is rescanned with strlen():
+//		char buf[4096];
+//		FixedStringSerialWriter out(buf, sizeof(buf));
+//		out.write(symbols, cnt);	//An array of FixedStrings
+//		send(buf, out.size());
+//		...
+//		FixedStringSerialReader in(buf, size);
+//		size_t n = in.read(symbols, max);
+//		if (in.failed()) ...	//A bad record or one longer than the capacity
+//
+// A string of under 128 chars in a 1 byte length (FixedString<256> or smaller) is already
+// the record in memory, so is written or read with one memcpy.
+// The writer stops at the first string that does not fit, the reader at the first record that
+// is cut short or too long for the string, failed() then says so and the position is left
+// at the start of that record.
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringSerialWriter
+{
+	char* m_data;
+	size_t m_size;
+	size_t m_pos;
+	bool m_failed;
+public:
+	FixedStringSerialWriter(void* data, size_t size) :m_data(static_cast<char*>(data)), m_size(size), m_pos(0), m_failed(false) {}
+
+	const char* data()const { return m_data; }
+	//Bytes written
+	size_t size()const { return m_pos; }
+	size_t available()const { return m_size - m_pos; }
+	bool failed()const { return m_failed; }
+	void clear()
+	{
+		m_pos = 0;
+		m_failed = false;
+	}
+
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	bool write(const FixedString<c_storage_size, OverrunPolicy>& s)
+	{
+		const size_t n = m_failed ? 0 : s.serialize(m_data + m_pos, available());
+		m_pos += n;
+		return !(m_failed = n == 0);
+	}
+	bool write(FixedStringView v)
+	{
+		if (m_failed || available() < FixedStringKernels::varint_size(v.length()) + v.length())
+			return !(m_failed = true);
+		m_pos += FixedStringKernels::put_varint(m_data + m_pos, v.length());
+		memcpy(m_data + m_pos, v.data(), v.length());
+		m_pos += v.length();
+		return true;
+	}
+	//Returns the number written
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_t write(const FixedString<c_storage_size, OverrunPolicy>* strings, size_t count)
+	{
+		size_t n = 0;
+		while (n < count && write(strings[n]))
+			n++;
+		return n;
+	}
+};
+
+class FixedStringSerialReader
+{
+	const char* m_data;
+	size_t m_size;
+	size_t m_pos;
+	bool m_failed;
+public:
+	FixedStringSerialReader(const void* data, size_t size) :m_data(static_cast<const char*>(data)), m_size(size), m_pos(0), m_failed(false) {}
+
+	//Bytes read
+	size_t pos()const { return m_pos; }
+	size_t available()const { return m_size - m_pos; }
+	bool done()const { return m_pos == m_size; }
+	bool failed()const { return m_failed; }
+
+	//false at the end or on a bad record (see failed())
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	bool read(FixedString<c_storage_size, OverrunPolicy>& s)
+	{
+		if (m_failed || done())
+			return false;
+		const size_t n = s.deserialize(m_data + m_pos, available());
+		m_pos += n;
+		return !(m_failed = n == 0);
+	}
+	//Zero copy - the view is into the buffer
+	bool read(FixedStringView& v)
+	{
+		if (m_failed || done())
+			return false;
+		uint32_t len = 0;
+		const size_t n = FixedStringKernels::get_varint(m_data + m_pos, available(), len);
+		if (n == 0 || available() - n < len)
+			return !(m_failed = true);
+		v = FixedStringView(m_data + m_pos + n, len);
+		m_pos += n + len;
+		return true;
+	}
+	//Returns the number read
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_t read(FixedString<c_storage_size, OverrunPolicy>* strings, size_t max)
+	{
+		size_t n = 0;
+		while (n < max && read(strings[n]))
+			n++;
+		return n;
+	}
+};
+
+#ifndef ARDUINO
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringSerialGather (non-Arduino, POSIX)
+// Serializes strings straight from where they are with writev(), no buffer to copy into:
+//		FixedStringSerialGather<> out;
+//		out.add(symbols, cnt);
+//		out.write_to(fd);
+//
+// A string whose bytes are already its record (see FixedStringSerialWriter) takes one iovec
+// pointing at the string itself, others take two: the varint (kept in the gather) and the
+// text. Up to c_max_iov iovecs, add() returns false when there is no room. The strings must
+// not change or move until written.
+// Short strings are cheaper packed with FixedStringSerialWriter and written with one write(),
+// an iovec costs more than copying a few bytes - the gather pays off as the strings grow.
+// write_to() writes everything added (IOV_MAX iovecs per writev()) then empties the gather,
+// a short write or an error (e.g. EAGAIN) leaves the rest to the next call.
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_max_iov = 1024>
+class FixedStringSerialGather
+{
+	iovec m_iov[c_max_iov];
+	char m_lengths[c_max_iov][FixedStringKernels::c_varint_max];
+	size_t m_cnt;
+	size_t m_first;		//First iovec not yet written
+	size_t m_size;		//Bytes not yet written
+public:
+	FixedStringSerialGather() :m_cnt(0), m_first(0), m_size(0) {}
+	FixedStringSerialGather(const FixedStringSerialGather&) = delete;
+	FixedStringSerialGather& operator=(const FixedStringSerialGather&) = delete;
+
+	const iovec* iov()const { return m_iov + m_first; }
+	size_t iov_count()const { return m_cnt - m_first; }
+	//Bytes not yet written
+	size_t size()const { return m_size; }
+	bool empty()const { return m_size == 0; }
+	//Drops anything not yet written
+	void clear() { m_cnt = m_first = m_size = 0; }
+
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	bool add(const FixedString<c_storage_size, OverrunPolicy>& s)
+	{
+		if (const void* record = s.serialized_data())
+		{
+			if (m_cnt == c_max_iov)
+				return false;
+			push(record, 1 + s.length());
+			return true;
+		}
+		return add(s.view());
+	}
+	bool add(FixedStringView v)
+	{
+		if (m_cnt + (v.empty() ? 1 : 2) > c_max_iov)
+			return false;
+		char* len = m_lengths[m_cnt];
+		push(len, FixedStringKernels::put_varint(len, v.length()));
+		if (!v.empty())
+			push(v.data(), v.length());
+		return true;
+	}
+	//Returns the number added
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	size_t add(const FixedString<c_storage_size, OverrunPolicy>* strings, size_t count)
+	{
+		size_t n = 0;
+		while (n < count && add(strings[n]))
+			n++;
+		return n;
+	}
+
+	//Returns the bytes written by this call, -1 on an error (see errno) before any were
+	ssize_t write_to(int fd)
+	{
+		ssize_t total = 0;
+		while (m_first < m_cnt)
+		{
+			const size_t cnt = m_cnt - m_first < IOV_MAX ? m_cnt - m_first : IOV_MAX;
+			const ssize_t written = writev(fd, m_iov + m_first, static_cast<int>(cnt));
+			if (written < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return total > 0 ? total : written;
+			}
+			if (written == 0)
+				return total;
+			total += written;
+			consume(static_cast<size_t>(written));
+		}
+		clear();
+		return total;
+	}
+private:
+	void push(const void* data, size_t len)
+	{
+		m_iov[m_cnt++] = iovec{ const_cast<void*>(data), len };
+		m_size += len;
+	}
+	//Drops the bytes written, the iovec written part way is moved on
+	void consume(size_t written)
+	{
+		m_size -= written;
+		for (; m_first < m_cnt && written >= m_iov[m_first].iov_len; m_first++)
+			written -= m_iov[m_first].iov_len;
+		if (written > 0)
+		{
+			m_iov[m_first].iov_base = static_cast<char*>(m_iov[m_first].iov_base) + written;
+			m_iov[m_first].iov_len -= written;
+		}
+	}
+};
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
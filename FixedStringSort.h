@@ -0,0 +1,255 @@
+// Fixed String - MSD radix sort of FixedString arrays
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGSORT_H
+#define _FIXEDSTRINGSORT_H
+#pragma once
+#include "FixedString.h"
+
+#ifndef ARDUINO
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringSort (non-Arduino)
+// Sorts FixedStrings into compareTo() order (operator<) with an MSD radix sort:
+//		std::vector<FixedString<16> > symbols = ...;
+//		FixedStringSort::sort(symbols.data(), symbols.data() + symbols.size());
+//		FixedStringSort::sort(symbols.data(), symbols.data() + symbols.size(), 0);//All cores
+//
+// Each pass buckets by one byte (bucket 0 = the string has ended, so shorter sorts first),
+// a run of bytes common to a whole bucket costs one counting pass each and no moves, and
+// the key width bounds the depth. Small buckets are insertion sorted from the current depth.
+// Only (index, 8 cached bytes) items are sorted, the strings are moved into place at the end.
+// threads: 1 = this thread, 0 = std::thread::hardware_concurrency(). Larger inputs are first
+// split until no bucket holds more than a share of the input, then the buckets are sorted
+// by the threads.
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace FixedStringSort
+{
+	namespace detail
+	{
+		using size_type = size_t;
+
+		//Buckets this size or less are insertion sorted
+		constexpr size_type c_small = 24;
+		//Inputs smaller than this are sorted on the calling thread
+		constexpr size_type c_parallel_min = 1u << 16;
+
+		struct Task
+		{
+			size_type begin;
+			size_type count;
+			size_type depth;
+			size_type base;//Offset of the bytes cached in the task's items
+		};
+
+		//8 bytes of the string from the task base, so a pass does not touch the strings
+		struct Item
+		{
+			unsigned char bytes[8];
+			uint32_t index;
+			uint32_t length;
+		};
+
+		template<typename T>
+		class Sorter
+		{
+			const T* m_strings;
+			std::vector<Item> m_items;
+			std::vector<Item> m_temp;
+		public:
+			Sorter(const T* strings, size_type count) :m_strings(strings), m_items(count), m_temp(count)
+			{
+				for (size_type i = 0; i < count; i++)
+				{
+					m_items[i].index = static_cast<uint32_t>(i);
+					m_items[i].length = static_cast<uint32_t>(strings[i].length());
+					load(m_items[i], 0);
+				}
+			}
+			size_type count()const { return m_items.size(); }
+			//Index of the string at sorted position i
+			size_type order(size_type i)const { return m_items[i].index; }
+
+			//One counting pass over the task, sub-buckets that need more sorting are pushed
+			void split(Task task, std::vector<Task>& pending)
+			{
+				Item* items = m_items.data() + task.begin;
+				for (;;)
+				{
+					if (task.depth - task.base >= 8)
+					{
+						task.base = task.depth;
+						for (size_type i = 0; i < task.count; i++)
+							load(items[i], task.base);
+					}
+					if (task.count <= c_small)
+					{
+						insertion_sort(items, task);
+						return;
+					}
+					size_type counts[257] = {};
+					for (size_type i = 0; i < task.count; i++)
+						counts[key(items[i], task)]++;
+					//All in one bucket: ended (all equal) or a common byte, go one deeper
+					const unsigned first = key(items[0], task);
+					if (counts[first] == task.count)
+					{
+						if (first == 0)
+							return;
+						task.depth++;
+						continue;
+					}
+					size_type starts[257];
+					size_type start = 0;
+					for (unsigned b = 0; b < 257; b++)
+					{
+						starts[b] = start;
+						start += counts[b];
+					}
+					Item* temp = m_temp.data() + task.begin;
+					for (size_type i = 0; i < task.count; i++)
+						temp[starts[key(items[i], task)]++] = items[i];
+					std::copy(temp, temp + task.count, items);
+					//Bucket 0 has ended so is already in order
+					size_type begin = task.begin + counts[0];
+					for (unsigned b = 1; b < 257; begin += counts[b++])
+					{
+						if (counts[b] > 1)
+							pending.push_back(Task{ begin, counts[b], task.depth + 1, task.base });
+					}
+					return;
+				}
+			}
+
+			void sort(Task task)
+			{
+				std::vector<Task> pending;
+				pending.push_back(task);
+				while (!pending.empty())
+				{
+					const Task next = pending.back();
+					pending.pop_back();
+					split(next, pending);
+				}
+			}
+
+			void sort_parallel(unsigned threads)
+			{
+				//Split the largest bucket until none is more than 1/(4 * threads) of the input
+				std::vector<Task> pending;
+				pending.push_back(Task{ 0, count(), 0, 0 });
+				const size_type share = count() / (4 * threads);
+				while (!pending.empty())
+				{
+					std::make_heap(pending.begin(), pending.end(), by_count);
+					std::pop_heap(pending.begin(), pending.end(), by_count);
+					const Task largest = pending.back();
+					if (largest.count <= share)
+						break;
+					pending.pop_back();
+					split(largest, pending);
+				}
+				//Largest first, each thread takes the next unsorted bucket
+				std::sort(pending.begin(), pending.end(), [](const Task& lhs, const Task& rhs) { return by_count(rhs, lhs); });
+				std::atomic<size_type> next(0);
+				auto worker = [&] {
+					for (size_type i = next++; i < pending.size(); i = next++)
+						sort(pending[i]);
+				};
+				std::vector<std::thread> pool;
+				for (unsigned t = 1; t < threads; t++)
+					pool.emplace_back(worker);
+				worker();
+				for (auto& thread : pool)
+					thread.join();
+			}
+		private:
+			static bool by_count(const Task& lhs, const Task& rhs) { return lhs.count < rhs.count; }
+			//0 once the string has ended, else byte + 1
+			static unsigned key(const Item& item, const Task& task)
+			{
+				return task.depth < item.length ? item.bytes[task.depth - task.base] + 1u : 0u;
+			}
+			void load(Item& item, size_type base)const
+			{
+				const size_type len = item.length > base ? std::min<size_type>(item.length - base, 8) : 0;
+				memcpy(item.bytes, m_strings[item.index].c_str() + base, len);
+				memset(item.bytes + len, 0, 8 - len);
+			}
+			//Strings sharing their first depth bytes, the cached bytes decide most without reading the strings
+			bool less(const Item& lhs, const Item& rhs, const Task& task)const
+			{
+				const size_type offset = task.depth - task.base;
+				const int cached = memcmp(lhs.bytes + offset, rhs.bytes + offset, 8 - offset);
+				if (cached != 0)
+					return cached < 0;
+				const size_type min_len = std::min(lhs.length, rhs.length);
+				const size_type next = task.base + 8;
+				const int res = min_len > next
+					? FixedStringKernels::compare(m_strings[lhs.index].c_str() + next, m_strings[rhs.index].c_str() + next, min_len - next)
+					: 0;
+				return res != 0 ? res < 0 : lhs.length < rhs.length;
+			}
+			void insertion_sort(Item* items, const Task& task)const
+			{
+				for (size_type i = 1; i < task.count; i++)
+				{
+					const Item item = items[i];
+					size_type j = i;
+					for (; j > 0 && less(item, items[j - 1], task); j--)
+						items[j] = items[j - 1];
+					items[j] = item;
+				}
+			}
+		};
+
+		//Gather into sorted order then move back - the reads are independent so overlap, unlike
+		//following the cycles of the permutation
+		template<typename T>
+		void permute(T* strings, const Sorter<T>& sorter)
+		{
+			std::vector<T> sorted;
+			sorted.reserve(sorter.count());
+			for (size_type i = 0; i < sorter.count(); i++)
+				sorted.push_back(static_cast<T&&>(strings[sorter.order(i)]));
+			std::move(sorted.begin(), sorted.end(), strings);
+		}
+	}
+
+	template<unsigned int c_storage_size, typename OverrunPolicy>
+	void sort(FixedString<c_storage_size, OverrunPolicy>* first, FixedString<c_storage_size, OverrunPolicy>* last, unsigned threads = 1)
+	{
+		if (last - first < 2)
+			return;
+		const auto count = static_cast<detail::size_type>(last - first);
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		detail::Sorter<FixedString<c_storage_size, OverrunPolicy> > sorter(first, count);
+		if (threads > 1 && count >= detail::c_parallel_min)
+			sorter.sort_parallel(threads);
+		else
+			sorter.sort(detail::Task{ 0, count, 0, 0 });
+		detail::permute(first, sorter);
+	}
+}
+
+#endif
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
@@ -0,0 +1,375 @@
+// Fixed String - non owning views and split/tokenize ranges
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+//This library is free software; you can redistribute it and/or
+//modify it under the terms of the GNU Lesser General Public
+//License as published by the Free Software Foundation; either
+//version 2.1 of the License, or (at your option) any later version.
+//
+//This library is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU
+//Lesser General Public License for more details.
+//
+//You should have received a copy of the GNU Lesser General Public
+//License along with this library; if not, write to the Free Software
+//Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110 - 1301  USA
+
+#ifndef _FIXEDSTRINGVIEW_H
+#define _FIXEDSTRINGVIEW_H
+#pragma once
+#include "FixedStringKernels.h"
+#ifndef ARDUINO
+#include <string_view>
+#endif
+
+class FixedStringSplit;
+class FixedStringTokens;
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringView
+// A non owning (pointer, length) view of some chars, e.g. part of a FixedString:
+//		FixedStringView name = s.view(0, 4);
+// Nothing is copied, the chars must outlive the view and a FixedString must not be
+// modified while viewed. The text is NOT null terminated, print with:
+//		printf("%.*s", (int)v.length(), v.data());
+// Converts to and from std::string_view on non-Arduino builds.
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringView
+{
+public:
+	using char_type = char;
+	using value_type = char_type;
+	using const_pointer = const value_type*;
+	using size_type = unsigned int;
+	static constexpr const size_type npos = (size_type)-1;
+private:
+	const_pointer m_str;
+	size_type m_len;
+public:
+	constexpr FixedStringView() :m_str(""), m_len(0) {}
+	constexpr FixedStringView(const_pointer data, size_type len) :m_str(data == NULL ? "" : data), m_len(data == NULL ? 0 : len) {}
+	FIXEDSTRING_CONSTEXPR FixedStringView(const_pointer str)
+		:m_str(str == NULL ? "" : str), m_len(str == NULL ? 0 : static_cast<size_type>(FixedStringKernels::length(str))) {}
+#ifndef ARDUINO
+	constexpr FixedStringView(std::string_view s) :m_str(s.data()), m_len(static_cast<size_type>(s.size())) {}
+	constexpr operator std::string_view()const { return std::string_view(m_str, m_len); }
+#endif
+
+	constexpr const_pointer data()const { return m_str; }
+	constexpr size_type length()const { return m_len; }
+	constexpr size_type size()const { return m_len; }
+	constexpr bool empty()const { return m_len == 0; }
+	constexpr const_pointer begin()const { return m_str; }
+	constexpr const_pointer end()const { return m_str + m_len; }
+	constexpr char_type charAt(size_type index)const { return index < m_len ? m_str[index] : 0; }
+	constexpr char_type operator[](size_type index)const { return charAt(index); }
+
+	//Same rules as FixedString::substring()
+	FIXEDSTRING_CONSTEXPR FixedStringView substring(size_type left, size_type right = npos)const
+	{
+		if (right == npos)
+			right = m_len;
+		else if (left > right)
+		{
+			auto temp = right;
+			right = left;
+			left = temp;
+		}
+		if (left >= m_len)
+			return FixedStringView(end(), 0);
+		if (right > m_len)
+			right = m_len;
+		return FixedStringView(m_str + left, right - left);
+	}
+	//Drop leading and/or trailing white space (' ', '\t'-'\r') from the view
+	FIXEDSTRING_CONSTEXPR void trim()
+	{
+		trim_right();
+		trim_left();
+	}
+	FIXEDSTRING_CONSTEXPR void trim_left()
+	{
+		const_pointer first = FixedStringKernels::find_not_space(m_str, m_len);
+		const size_type skip = first == NULL ? m_len : static_cast<size_type>(first - m_str);
+		m_str += skip;
+		m_len -= skip;
+	}
+	FIXEDSTRING_CONSTEXPR void trim_right()
+	{
+		const_pointer last = FixedStringKernels::find_last_not_space(m_str, m_len);
+		m_len = last == NULL ? 0 : static_cast<size_type>(last - m_str) + 1;
+	}
+
+	//comparison
+	FIXEDSTRING_CONSTEXPR bool equals(FixedStringView rhs)const
+	{
+		return m_len == rhs.m_len && FixedStringKernels::compare(m_str, rhs.m_str, m_len) == 0;
+	}
+	FIXEDSTRING_CONSTEXPR bool equalsIgnoreCase(FixedStringView rhs)const
+	{
+		return m_len == rhs.m_len && FixedStringKernels::compare_ignore_case(m_str, rhs.m_str, m_len) == 0;
+	}
+	FIXEDSTRING_CONSTEXPR int compareTo(FixedStringView rhs)const
+	{
+		const auto diff = FixedStringKernels::compare(m_str, rhs.m_str, m_len < rhs.m_len ? m_len : rhs.m_len);
+		if (diff != 0)
+			return diff;
+		return m_len == rhs.m_len ? 0 : (m_len < rhs.m_len ? -1 : 1);
+	}
+	friend FIXEDSTRING_CONSTEXPR bool operator==(FixedStringView lhs, FixedStringView rhs) { return lhs.equals(rhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(FixedStringView lhs, FixedStringView rhs) { return !lhs.equals(rhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator<(FixedStringView lhs, FixedStringView rhs) { return lhs.compareTo(rhs) < 0; }
+	friend FIXEDSTRING_CONSTEXPR bool operator==(FixedStringView lhs, const_pointer rhs) { return lhs.equals(rhs); }
+	friend FIXEDSTRING_CONSTEXPR bool operator!=(FixedStringView lhs, const_pointer rhs) { return !lhs.equals(rhs); }
+#ifndef ARDUINO
+	//Exact matches, otherwise ambiguous with the std::string_view operators
+	friend constexpr bool operator==(FixedStringView lhs, std::string_view rhs) { return std::string_view(lhs) == rhs; }
+	friend constexpr bool operator!=(FixedStringView lhs, std::string_view rhs) { return std::string_view(lhs) != rhs; }
+	friend constexpr bool operator==(std::string_view lhs, FixedStringView rhs) { return lhs == std::string_view(rhs); }
+	friend constexpr bool operator!=(std::string_view lhs, FixedStringView rhs) { return lhs != std::string_view(rhs); }
+#endif
+
+	//search
+	FIXEDSTRING_CONSTEXPR bool startsWith(FixedStringView s)const
+	{
+		return s.m_len <= m_len && FixedStringKernels::compare(m_str, s.m_str, s.m_len) == 0;
+	}
+	FIXEDSTRING_CONSTEXPR bool endsWith(FixedStringView s)const
+	{
+		return s.m_len <= m_len && FixedStringKernels::compare(end() - s.m_len, s.m_str, s.m_len) == 0;
+	}
+	FIXEDSTRING_CONSTEXPR int indexOf(char_type c, size_type start_pos = 0)const
+	{
+		if (start_pos >= m_len)
+			return -1;
+		return to_index(FixedStringKernels::find_char(m_str + start_pos, m_len - start_pos, c));
+	}
+	FIXEDSTRING_CONSTEXPR int indexOf(FixedStringView s, size_type start_pos = 0)const
+	{
+		if (start_pos >= m_len || s.empty() || start_pos + s.m_len > m_len)
+			return -1;
+		return to_index(FixedStringKernels::find_str(m_str + start_pos, m_len - start_pos, s.m_str, s.m_len));
+	}
+	FIXEDSTRING_CONSTEXPR int lastIndexOf(char_type c)const
+	{
+		return to_index(FixedStringKernels::find_last_char(m_str, m_len, c));
+	}
+
+	//Same as FixedStringKernels::hash(data(), length()), so equal to FixedString::hash()
+	FIXEDSTRING_CONSTEXPR size_t hash()const { return FixedStringKernels::hash(m_str, m_len); }
+
+	//Checked number parsing with the std::from_chars rules (no leading space or '+'), see
+	//FixedStringParse. radix is ignored for float & double
+	template<typename T>
+	FixedStringParse parse(T& value, Radix radix = base10)const { return FixedStringKernels::parse_number(m_str, m_len, value, radix); }
+	//Numbers separated by delim into values (at most max), returns the count parsed. Stops at
+	//the first field that is not wholly a number, result then has its position and error
+	template<typename T>
+	size_type parse_list(T* values, size_type max, char_type delim = ',', Radix radix = base10, FixedStringParse* result = NULL)const
+	{
+		FixedStringParse res = FixedStringKernels::parse_result(0, FixedStringParse::none);
+		size_type count = 0;
+		for (size_type pos = 0; count < max && m_len > 0; )
+		{
+			const FixedStringParse field = FixedStringKernels::parse_number(m_str + pos, m_len - pos, values[count], radix);
+			res = FixedStringKernels::parse_result(pos + field.pos, field.error);
+			if (res.ok() && res.pos < m_len && m_str[res.pos] != delim)
+				res.error = FixedStringParse::invalid;
+			if (!res.ok())
+				break;
+			count++;
+			if (res.pos == m_len)
+				break;
+			pos = ++res.pos;
+		}
+		if (result != NULL)
+			*result = res;
+		return count;
+	}
+
+	//Lazy ranges of sub views, see FixedStringSplit & FixedStringTokens
+	FIXEDSTRING_CONSTEXPR FixedStringSplit split(char_type delim)const;
+	FIXEDSTRING_CONSTEXPR FixedStringTokens tokenize(const_pointer delims)const;
+private:
+	FIXEDSTRING_CONSTEXPR int to_index(const_pointer p)const { return p == NULL ? -1 : static_cast<int>(p - m_str); }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringSplit
+// The fields of a view separated by a single char, empty fields included, so n delimiters
+// always give n + 1 fields (CSV style):
+//		for (FixedStringView field : line.split(','))
+// Each 16/32 byte block is matched once with SIMD, the fields within it are found from
+// the bit mask of delimiter positions. No copies and no strlen().
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringSplit
+{
+public:
+	using char_type = FixedStringView::char_type;
+	using const_pointer = FixedStringView::const_pointer;
+	using size_type = FixedStringView::size_type;
+
+	class iterator
+	{
+		FixedStringView m_field;
+		const_pointer m_end;//end of the whole text
+		const_pointer m_block;//block of the text being matched
+		uint32_t m_mask;//delimiters in m_block not yet reached
+		char_type m_delim;
+		bool m_done;
+		friend class FixedStringSplit;
+		FIXEDSTRING_CONSTEXPR iterator(const_pointer start, const_pointer end, char_type delim, bool done)
+			:m_field(), m_end(end), m_block(start), m_mask(0), m_delim(delim), m_done(done)
+		{
+			if (done)
+				return;
+			m_mask = FixedStringKernels::match_mask(start, block_len(), delim);
+			find_field(start);
+		}
+		FIXEDSTRING_CONSTEXPR size_type block_len()const { return static_cast<size_type>(m_end - m_block); }
+		//Each block is matched once, fields within it come from the mask
+		FIXEDSTRING_CONSTEXPR const_pointer next_delim()
+		{
+			while (m_mask == 0)
+			{
+				if (block_len() <= FixedStringKernels::c_mask_block)
+					return NULL;
+				m_block += FixedStringKernels::c_mask_block;
+				m_mask = FixedStringKernels::match_mask(m_block, block_len(), m_delim);
+			}
+			const_pointer p = m_block + FixedStringKernels::lowest_bit(m_mask);
+			m_mask &= m_mask - 1;
+			return p;
+		}
+		FIXEDSTRING_CONSTEXPR void find_field(const_pointer start)
+		{
+			const_pointer p = next_delim();
+			m_field = FixedStringView(start, static_cast<size_type>((p == NULL ? m_end : p) - start));
+		}
+	public:
+		FIXEDSTRING_CONSTEXPR const FixedStringView& operator*()const { return m_field; }
+		FIXEDSTRING_CONSTEXPR const FixedStringView* operator->()const { return &m_field; }
+		FIXEDSTRING_CONSTEXPR iterator& operator++()
+		{
+			if (m_field.end() == m_end)
+				m_done = true;//that was the last field
+			else
+				find_field(m_field.end() + 1);
+			return *this;
+		}
+		FIXEDSTRING_CONSTEXPR bool operator==(const iterator& rhs)const
+		{
+			return m_done == rhs.m_done && (m_done || m_field.data() == rhs.m_field.data());
+		}
+		FIXEDSTRING_CONSTEXPR bool operator!=(const iterator& rhs)const { return !(*this == rhs); }
+	};
+
+	constexpr FixedStringSplit(FixedStringView text, char_type delim) :m_text(text), m_delim(delim) {}
+	FIXEDSTRING_CONSTEXPR iterator begin()const { return iterator(m_text.begin(), m_text.end(), m_delim, false); }
+	FIXEDSTRING_CONSTEXPR iterator end()const { return iterator(m_text.end(), m_text.end(), m_delim, true); }
+	//Field by position, empty if there are not that many
+	FIXEDSTRING_CONSTEXPR FixedStringView operator[](size_type index)const
+	{
+		for (auto it = begin(); it != end(); ++it)
+		{
+			if (index-- == 0)
+				return *it;
+		}
+		return FixedStringView(m_text.end(), 0);
+	}
+	FIXEDSTRING_CONSTEXPR size_type count()const
+	{
+		size_type cnt = 0;
+		for (auto it = begin(); it != end(); ++it)
+			cnt++;
+		return cnt;
+	}
+private:
+	FixedStringView m_text;
+	char_type m_delim;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringTokens
+// The runs of chars between any of a set of delimiters, empty tokens are skipped
+// (strtok style, but the text is not modified):
+//		for (FixedStringView word : s.tokenize(" \t,"))
+// The delimiters are copied into a 256 bit table so each char costs one lookup.
+///////////////////////////////////////////////////////////////////////////////////////////
+class FixedStringTokens
+{
+public:
+	using char_type = FixedStringView::char_type;
+	using const_pointer = FixedStringView::const_pointer;
+	using size_type = FixedStringView::size_type;
+
+	class iterator
+	{
+		FixedStringView m_token;
+		const FixedStringTokens* m_owner;
+		friend class FixedStringTokens;
+		FIXEDSTRING_CONSTEXPR iterator(const FixedStringTokens* owner, const_pointer start)
+			:m_token(), m_owner(owner)
+		{
+			find_token(start);
+		}
+		FIXEDSTRING_CONSTEXPR void find_token(const_pointer p)
+		{
+			const_pointer end = m_owner->m_text.end();
+			while (p != end && m_owner->is_delim(*p))
+				p++;
+			const_pointer start = p;
+			while (p != end && !m_owner->is_delim(*p))
+				p++;
+			m_token = FixedStringView(start, static_cast<size_type>(p - start));
+		}
+	public:
+		FIXEDSTRING_CONSTEXPR const FixedStringView& operator*()const { return m_token; }
+		FIXEDSTRING_CONSTEXPR const FixedStringView* operator->()const { return &m_token; }
+		FIXEDSTRING_CONSTEXPR iterator& operator++()
+		{
+			find_token(m_token.end());
+			return *this;
+		}
+		//Only the end iterator has an empty token
+		FIXEDSTRING_CONSTEXPR bool operator==(const iterator& rhs)const
+		{
+			return m_token.data() == rhs.m_token.data() || (m_token.empty() && rhs.m_token.empty());
+		}
+		FIXEDSTRING_CONSTEXPR bool operator!=(const iterator& rhs)const { return !(*this == rhs); }
+	};
+
+	FIXEDSTRING_CONSTEXPR FixedStringTokens(FixedStringView text, const_pointer delims) :m_text(text), m_delims()
+	{
+		for (; delims != NULL && *delims != '\0'; delims++)
+		{
+			const auto c = static_cast<unsigned char>(*delims);
+			m_delims[c >> 3] = static_cast<unsigned char>(m_delims[c >> 3] | (1u << (c & 7)));
+		}
+	}
+	//Iterators refer to this object, so it must outlive them (as in a range for loop)
+	FIXEDSTRING_CONSTEXPR iterator begin()const { return iterator(this, m_text.begin()); }
+	FIXEDSTRING_CONSTEXPR iterator end()const { return iterator(this, m_text.end()); }
+	FIXEDSTRING_CONSTEXPR size_type count()const
+	{
+		size_type cnt = 0;
+		for (auto it = begin(); it != end(); ++it)
+			cnt++;
+		return cnt;
+	}
+private:
+	FixedStringView m_text;
+	unsigned char m_delims[32];
+	FIXEDSTRING_CONSTEXPR bool is_delim(char_type c)const
+	{
+		const auto u = static_cast<unsigned char>(c);
+		return (m_delims[u >> 3] & (1u << (u & 7))) != 0;
+	}
+};
+
+inline FIXEDSTRING_CONSTEXPR FixedStringSplit FixedStringView::split(char_type delim)const { return FixedStringSplit(*this, delim); }
+inline FIXEDSTRING_CONSTEXPR FixedStringTokens FixedStringView::tokenize(const_pointer delims)const { return FixedStringTokens(*this, delims); }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+#endif
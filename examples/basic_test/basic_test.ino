@@ -5,6 +5,10 @@
 //
 
 #include <FixedString.h>
+#include <FixedStringArray.h>
+#include <FixedStringHybrid.h>
+#include <FixedStringMatcher.h>
+#include <FixedStringSerial.h>
 
 static int fail_cnt=0;
 void test(bool b_val,int test_no,const char* val="")
@@ -33,6 +37,19 @@ void test_equals(const char* s1,const char* s2,int test_no)
 }
 DEFINE_PSTR(cFlashAlphabet,"abcdefghijklmnopqrstuvwxyz");
 
+#ifdef FIXEDSTRING_HAS_CONSTEXPR
+//C++20: built and searched at compile time, and usable as a template argument
+constexpr FixedString<32> cContentType = FixedString<32>("Content-") + "Type";
+static_assert(cContentType == "Content-Type" && cContentType.indexOf("Type") == 8 && cContentType.startsWith("Content"), "constexpr FixedString");
+template<FixedString<16> c_name>
+struct NamedField
+{
+	static constexpr unsigned int length() { return c_name.length(); }
+	static constexpr bool is(const char* name) { return c_name == name; }
+};
+static_assert(NamedField<FixedString<16>("Accept")>::length() == 6 && NamedField<FixedString<16>("Accept")>::is("Accept"), "FixedString template argument");
+#endif
+
 void TestFixedString()
 {
 	FixedString<32> s2(GET_PSTR(cFlashAlphabet));
@@ -72,6 +89,7 @@ void TestFixedString()
 	s1.replace("def","DEF");
 	test(s1!=s2,22);
 	test(s1.equalsIgnoreCase(GET_PSTR(cFlashAlphabet)),23);
+	test(s1.compareToIgnoreCase("ABCDEFGHIJKLMNOPQRSTUVWXYZ")==0 && s1.compareToIgnoreCase("abcdf")<0,24);
 
 	test(FixedString<8>(3)=="3",30);
 	test(FixedString<8>(3l)=="3",31);
@@ -94,6 +112,12 @@ void TestFixedString()
 	test(s1=="BUDDY BOY",41);
 	s1.toLowerCase();
 	test(s1=="buddy boy",42);
+	FixedString<32> sct(" \t Content-Type \r");
+	sct.trim_right();
+	test(sct==" \t Content-Type",43);
+	sct.trim_left();
+	sct.toLowerCase();
+	test(sct=="content-type",44);
 
 
 	test(s1.indexOf('u')==1,50);
@@ -124,6 +148,14 @@ void TestFixedString()
 	test(s1=="buddjjjaab__boy",69);
 	s1.replace("jjj","");
 	test(s1=="buddaab__boy",70);
+	//replace_all: shrink, same length & grow in place, returns the number replaced
+	FixedString<16> sra("a-b-c-d");
+	test(sra.replace_all("-", "") == 3 && sra == "abcd" && sra.replace_all("bc", "XY") == 1 && sra == "aXYd" && sra.replace_all("z", "q") == 0, 71);
+	sra = "a.b.c";
+	test(sra.replace_all(".", "::") == 2 && sra == "a::b::c" && sra.length() == 7, 72);
+	//A grow past the capacity keeps the start of the result and still counts every match
+	FixedString<8> sro("a.b.c");
+	test(sro.replace_all(".", "--") == 2 && sro == "a--b--", 73);
 
 	s1="	 fred is a knob.   ";
 	s1.trim();
@@ -185,6 +217,15 @@ void TestFixedString()
 
 	test(s25.lastIndexOf("tu") == 19, 113);
 	test(s25.lastIndexOf("tu", 18) == 4, 114);
+	//Longer strings are searched a 16/32 byte block at a time
+	FixedString<96> sx("the quick brown fox jumps over the lazy dog, the quick brown cat naps under it");
+	test(sx.length() == 78 && sx.indexOf('z') == 37 && sx.indexOf('q', 5) == 49 && sx.indexOf('t', 64) == 77, 115);
+	test(sx.indexOf("over the lazy") == 26 && sx.indexOf("brown fox jumps over the") == 10 && sx.indexOf("the quick brown cat") == 45, 116);
+	test(sx.indexOf('o', 16) == 17 && sx.indexOf('o', 32) == 41 && sx.indexOf('o', 48) == 57 && sx.indexOf("the", 16) == 31 && sx.indexOf("the", 32) == 45, 117);
+	test(sx.lastIndexOf('o', 16) == 12 && sx.lastIndexOf('o', 31) == 26 && sx.lastIndexOf('o', 47) == 41 && sx.lastIndexOf("the quick") == 45
+		&& sx.lastIndexOf("the quick", 44) == 0 && sx.lastIndexOf("brown fox jumps over the", 47) == 10, 118);
+	test(sx.indexOf('!') == -1 && sx.indexOf("quick brown dog") == -1 && sx.indexOf("it", 77) == -1 && sx.lastIndexOf("zebra") == -1
+		&& sx.lastIndexOf("brown fox jumps over the", 9) == -1, 119);
 
 	unsigned char out8u=0xFF;
 	test_equals(FixedString<16>(out8u, base10).c_str(),"255", 120);
@@ -222,6 +263,138 @@ void TestFixedString()
 	test_equals(FixedString<48>(outLong, base8).c_str(),"326711", 147);
 	test_equals(FixedString<48>(outLong, base16).c_str(),"1adc9", 148);
 
+	//Numbers are truncated on concat BUT must fit in full on assign
+	FixedString<8> sn("ab");
+	sn += 123456789l;
+	test_equals(sn.c_str(),"ab1234", 150);
+	test(!sn.assign(1234567l) && sn.empty(), 151);
+	test(sn.assign(-12345l) && sn == "-12345", 152);
+	sn = "x";
+	sn.concat(-2.5, 1);
+	test_equals(sn.c_str(),"x-2.5", 153);
+
+	//{} formatting
+	FixedString<40> sf;
+	sf.fmt("{}: {} of {} ({:.1}%)", "job", 3, 10u, 30.25);
+	test_equals(sf.c_str(),"job: 3 of 10 (30.2%)", 160);
+	sf.fmt("{:x} {:b} [{:4}] [{:3}] {{{}}}", 255, 5u, -7, "ab", true);
+	test_equals(sf.c_str(),"ff 101 [  -7] [ab ] {true}", 161);
+	test(!sn.fmt("{}-{}", "abc", 12345) && sn == "abc-12", 162);
+
+	//Checked parsing
+	FixedString<40> nums("12,-7,0x1f,300");
+	int vals[4];
+	FixedStringParse pr;
+	test(nums.parse_list(vals, 4, ',', base10, &pr) == 2 && vals[1] == -7 && pr.error == FixedStringParse::invalid && pr.pos == 7, 155);
+	unsigned char u8 = 0;
+	test(nums.view(11).parse(u8).error == FixedStringParse::out_of_range && nums.view(8, 10).parse(u8, base16).ok() && u8 == 0x1f, 156);
+	long li = 0;
+	double dv = 0;
+	test(!FixedString<16>("12abc").get_int(li) && li == 12 && FixedString<16>(" +42 ").get_int(li) && li == 42, 157);
+	test(FixedString<16>("-2.5e1").get_float(dv) && dv == -25.0 && FixedString<16>("ff").to_int<int>(base16) == 255, 158);
+
+	//Zero copy views and fields
+	FixedString<40> csv("AAPL,101.5,,200");
+	FixedStringView fields[5];
+	int nf = 0;
+	for (FixedStringView f : csv.split(','))
+		fields[nf++] = f;
+	test(nf == 4 && fields[0] == "AAPL" && fields[2].empty() && fields[3] == "200", 165);
+	test(csv.split(',')[1] == "101.5" && csv.view(5, 8) == "101", 166);
+	nf = 0;
+	for (FixedStringView t : FixedStringView("  a b\tcd ").tokenize(" \t"))
+		nf += t.length();
+	test(nf == 4, 167);
+	FixedString<16> sym(csv.split(',')[0]);
+	sym += csv.view(4, 5);
+	test(sym == "AAPL," && sym.startsWith(csv.view(0, 2)) && sym.indexOf(FixedStringView(",", 1)) == 4, 168);
+
+	//Overrun policy
+	FixedString<8, FixedStringOverrunCount> so("abcd");
+	test(!so.concat("efgh") && so == "abcdef" && FixedStringOverrunCount::count() == 1, 175);
+	test(so.replace("ef", "e") && !so.insert(0, "xy") && FixedStringOverrunCount::count() == 2, 176);
+	FixedString<8, FixedStringOverrunCount> sor("a.b.c");
+	test(sor.replace_all(".", "--") == 2 && sor == "a--b--" && FixedStringOverrunCount::count() == 3, 177);
+
+	//Columnar array
+	static FixedStringArray<16, 8> col;
+	FixedStringArray<16, 8>::Selection sel;
+	test(col.push_back("AAPL.O") && col.push_back("MSFT.O") && col.push_back(csv.split(',')[0]) && !col.push_back("0123456789abcdefg"), 180);
+	col.startsWith("AAPL", sel);
+	test(sel.count() == 2 && sel[0] && !sel[1] && sel[2] && col.find("MSFT.O") == 1 && col[2] == "AAPL", 181);
+	col.endsWith(".O", sel);
+	test(sel.count() == 2 && !sel[2] && col.set(2, "IBM.O") && col.length(2) == 5, 182);
+
+	//Over 256 bytes the length takes 2 bytes
+	FixedString<300> sl;
+	for (int i = 0; i < 30; i++)
+		sl += "0123456789";
+	test(sl.capacity() == 297 && sl.length() == 297 && sl.lastIndexOf('6') == 296, 170);
+	//Copies only move the used bytes
+	FixedString<300> sc(sl);
+	sc = "short";
+	sl = sc;
+	FixedString<300> moved[1];
+	FixedString<300>::relocate(moved, &sl, 1);
+	test(sl == "short" && sl.length() == 5 && moved[0] == sl && FixedStringRelocatable<FixedString<300> >::value, 171);
+	//Hybrid strings spill to the arena rather than truncate
+	FixedStringArenaBuffer<256> arena;
+	FixedStringHybrid<8> sh(&arena);
+	test(sh.assign("1234567") && !sh.spilled() && sh.concat("89abc") && sh.spilled() && sh == "123456789abc", 185);
+	test(sh.replace_all("9", "-nine-") == 1 && sh == "12345678-nine-abc" && sh.indexOf("abc") == 14 && arena.used() > 0, 186);
+	FixedStringHybrid<8, FixedStringOverrunSilent> st;
+	test(!st.assign("123456789") && st == "1234567" && st.capacity() == 7, 187);
+	//No arena: a replace that overflows keeps the start of the whole result
+	FixedStringHybrid<8, FixedStringOverrunSilent> shr("ccababb");
+	test(shr.replace_all("c", "aa") == 2 && shr == "aaaaaba" && !shr.replace("b", "xyz") && shr == "aaaaaxy", 188);
+	//A move between arenas copies, the text must not live in the other arena
+	FixedStringArenaBuffer<64> arena2;
+	FixedStringHybrid<8> sa(&arena), sb(&arena2);
+	sb = "spilled to arena2";
+	sa = static_cast<FixedStringHybrid<8>&&>(sb);
+	arena2.reset();
+	FixedStringHybrid<8> sc2("overwrites arena2", &arena2);
+	test(sa == "spilled to arena2" && sc2 == "overwrites arena2", 189);
+	arena.reset();
+	//Many patterns found in one pass
+	FixedStringMatcher<16, 8> words(true);
+	test(words.add("he") == 0 && words.add("She") == 1 && words.add("hers") == 2 && words.add("HE") == 0 && words.size() == 3, 190);
+	words.compile();
+	FixedStringMatch m;
+	test(words.contains("ushers") && !words.contains("house") && words.indexOf("ushers", &m) == 1 && m.id == 1 && m.length == 3, 191);
+	const FixedStringView reps[] = { "it", "they", "theirs" };
+	FixedString<32> sm("she said hers, he said");
+	test(words.find_all(sm, [](const FixedStringMatch&) {}) == 5 && words.replace_all(sm, reps) == 3 && sm == "they said theirs, it said", 192);
+	//A result cut at the capacity still counts every match
+	FixedStringMatcher<4, 4> one;
+	one.add("a");
+	one.compile();
+	const FixedStringView grow[] = { "xxxx" };
+	FixedString<16> sg("a a a a a a a");
+	test(one.replace_all(sg, grow) == 7 && sg == "xxxx xxxx xxxx", 193);
+	//Binary records: varint length then the text, read back into any size that fits
+	char wire[64];
+	FixedStringSerialWriter wr(wire, sizeof(wire));
+	const FixedString<16> digits("0123456789");
+	test(wr.write(sm) && wr.write(digits) && wr.size() == 37 && wire[0] == 25 && wire[26] == 10, 194);
+	FixedString<32> rd1;
+	FixedString<8> rd2("keep");
+	FixedStringSerialReader rr(wire, wr.size());
+	test(rr.read(rd1) && rd1 == sm && !rr.read(rd2) && rr.failed() && rd2 == "keep" && rr.pos() == 26, 195);
+	//Chained + is written in one pass, each + limited as if added one at a time
+	FixedString<16> sk("AAPL");
+	FixedString<32> key = sk + '.' + "O" + ':' + sk;
+	test_equals(key.c_str(),"AAPL.O:AAPL",200);
+	key = "<" + key + ">";
+	test_equals(key.c_str(),"<AAPL.O:AAPL>",201);
+	sk = sk + sk + sk + sk;
+	test_equals(sk.c_str(),"AAPLAAPLAAPLAA",202);
+	//The expression can be read and compared as it stands, and a temporary's sum kept
+	test_equals((key + '!').c_str(),"<AAPL.O:AAPL>!",203);
+	test(key + '!' == "<AAPL.O:AAPL>!" && "<AAPL" < key + sk && key + sk != key, 204);
+	auto kept = FixedString<8>("AA") + "PL";
+	test(kept == "AAPL", 205);
+
 }
 
 void setup() 
@@ -0,0 +1,918 @@
+// Fixed String - host benchmark
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+// Compares FixedString<> against std::string and raw char[] buffers (strcpy/strcat etc)
+// using the non-Arduino C++17 path of FixedString.h.
+//
+// Build & run (from this folder):
+//		g++ -O2 -std=c++17 -I../.. FixedStringBench.cpp -o FixedStringBench
+//		./FixedStringBench [filter]
+//
+// Add -DFIXEDSTRING_ZERO_PAD to time equals() in zero padded mode.
+// Each result is the mean time per operation in nanoseconds.
+// Capacities 1024 & 4096 use the wider length type (see FixedStringLength).
+// An optional filter argument only runs benchmarks whose name contains the filter text.
+
+#include "FixedString.h"
+#include "FixedStringMap.h"
+#include "FixedStringArray.h"
+#include "FixedStringPool.h"
+#include "FixedStringSort.h"
+#include "FixedStringReader.h"
+#include "FixedStringHybrid.h"
+#include "FixedStringQueue.h"
+#include "FixedStringMatcher.h"
+#include "FixedStringSerial.h"
+#include <string>
+#include <unordered_map>
+#include <chrono>
+#include <strings.h>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <fcntl.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// Harness
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+	const char* g_filter = nullptr;
+	volatile unsigned long g_sink = 0;
+
+	//Stop the optimiser removing the work being timed
+	template<typename T>
+	inline void keep(const T& val)
+	{
+		asm volatile("" : : "g"(&val) : "memory");
+	}
+	inline void keep_value(unsigned long v) { g_sink = g_sink + v; }
+
+	template<typename Fn>
+	double time_ns(Fn&& fn)
+	{
+		using clock = std::chrono::steady_clock;
+		//Warm up AND calibrate so each run takes ~20ms
+		unsigned long iters = 1000;
+		for (;;)
+		{
+			const auto t0 = clock::now();
+			for (unsigned long i = 0; i < iters; i++)
+				fn();
+			const auto ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+			if (ns > 20e6 || iters >= (1ul << 28))
+				return ns / static_cast<double>(iters);
+			iters *= (ns < 1e6) ? 16 : 2;
+		}
+	}
+	bool enabled(const char* name)
+	{
+		return g_filter == nullptr || strstr(name, g_filter) != nullptr;
+	}
+	template<typename FnFixed, typename FnStd, typename FnRaw>
+	void run(const char* name, unsigned int cap, FnFixed&& fixed, FnStd&& std_str, FnRaw&& raw)
+	{
+		if (!enabled(name))
+			return;
+		const auto t_fixed = time_ns(fixed);
+		const auto t_std = time_ns(std_str);
+		const auto t_raw = time_ns(raw);
+		printf("%-22s %5u %12.2f %12.2f %12.2f %8.2fx\n", name, cap, t_fixed, t_std, t_raw, t_std / t_fixed);
+	}
+	void header()
+	{
+		printf("%-22s %5s %12s %12s %12s %9s\n", "benchmark", "cap", "FixedString", "std::string", "char[]", "std/fixed");
+	}
+
+	//Test text sized to ~3/4 of the string capacity
+	std::string make_text(unsigned int cap)
+	{
+		static const char words[] = "the quick brown fox jumps over the lazy dog ";
+		std::string s;
+		while (s.size() < cap * 3 / 4)
+			s += words[s.size() % (sizeof(words) - 1)];
+		return s;
+	}
+
+	//Raw char[] helpers matching FixedString semantics
+	void raw_replace(char* buf, size_t buf_size, const char* s, const char* new_s)
+	{
+		const auto src_len = strlen(s);
+		const auto repl_len = strlen(new_s);
+		for (char* p = strstr(buf, s); p != nullptr; p = strstr(p + repl_len, s))
+		{
+			const auto tail = strlen(p + src_len) + 1;
+			if (static_cast<size_t>(p - buf) + repl_len + tail > buf_size)
+				break;
+			memmove(p + repl_len, p + src_len, tail);
+			memcpy(p, new_s, repl_len);
+		}
+	}
+	const char* raw_last_index_of(const char* buf, const char* s)
+	{
+		const char* found = nullptr;
+		for (const char* p = strstr(buf, s); p != nullptr; p = strstr(p + 1, s))
+			found = p;
+		return found;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks for one capacity
+///////////////////////////////////////////////////////////////////////////////////////////
+template<unsigned int c_size>
+void bench_capacity()
+{
+	using FS = FixedString<c_size>;
+	constexpr auto cap = FS::capacity();
+	const std::string text = make_text(cap);
+	const FS fs_text(text.c_str());
+	char raw_text[c_size]{};
+	strncpy(raw_text, text.c_str(), sizeof(raw_text) - 1);
+	const char* needle = "lazy";
+	const char* piece = "abc ";
+
+	run("concat", cap,
+		[&] { FS s; while (s.available() >= 4) s.concat(piece); keep(s); },
+		[&] { std::string s; while (s.size() + 4 <= cap) s += piece; keep(s); },
+		[&] { char s[c_size]{}; size_t n = 0; while (n + 4 <= cap) { strcat(s, piece); n += 4; } keep(s); });
+
+	//Every append truncated, with a policy that does no I/O
+	using FSSilent = FixedString<c_size, FixedStringOverrunSilent>;
+	const FSSilent full_text(fs_text.c_str());
+	run("concat(truncated)", cap,
+		[&] { FSSilent s(full_text); s.concat(text.c_str(), static_cast<unsigned int>(text.size())); keep(s); },
+		[&] { std::string s(text); s.append(text, 0, cap - s.size()); keep(s); },
+		[&] { char s[c_size]; memcpy(s, raw_text, sizeof(s)); strncat(s, raw_text, cap - strlen(s)); keep(s); });
+
+	run("format", cap,
+		[&] { FS s; s.format("%s:%d:%u", "id", -12345, 678u); keep(s); },
+		[&] { std::string s(64, '\0'); s.resize(static_cast<size_t>(snprintf(&s[0], s.size(), "%s:%d:%u", "id", -12345, 678u))); keep(s); },
+		[&] { char s[c_size]; snprintf(s, sizeof(s), "%s:%d:%u", "id", -12345, 678u); keep(s); });
+
+	run("fmt", cap,
+		[&] { FS s; s.fmt("{}:{}:{}", "id", -12345, 678u); keep(s); },
+		[&] { std::string s("id"); s += ':'; s += std::to_string(-12345); s += ':'; s += std::to_string(678u); keep(s); },
+		[&] { char s[c_size]; snprintf(s, sizeof(s), "%s:%d:%u", "id", -12345, 678u); keep(s); });
+
+	run("indexOf(char)", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.indexOf('z'))); },
+		[&] { keep_value(static_cast<unsigned long>(text.find('z'))); },
+		[&] { keep_value(reinterpret_cast<uintptr_t>(strchr(raw_text, 'z'))); });
+
+	run("indexOf(str)", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.indexOf(needle))); },
+		[&] { keep_value(static_cast<unsigned long>(text.find(needle))); },
+		[&] { keep_value(reinterpret_cast<uintptr_t>(strstr(raw_text, needle))); });
+
+	run("lastIndexOf(char)", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.lastIndexOf('t'))); },
+		[&] { keep_value(static_cast<unsigned long>(text.rfind('t'))); },
+		[&] { keep_value(reinterpret_cast<uintptr_t>(strrchr(raw_text, 't'))); });
+
+	run("lastIndexOf(str)", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.lastIndexOf("the"))); },
+		[&] { keep_value(static_cast<unsigned long>(text.rfind("the"))); },
+		[&] { keep_value(reinterpret_cast<uintptr_t>(raw_last_index_of(raw_text, "the"))); });
+
+	run("replace(str)", cap,
+		[&] { FS s(fs_text); s.replace("the", "a"); keep(s); },
+		[&] {
+			std::string s(text);
+			for (auto p = s.find("the"); p != std::string::npos; p = s.find("the", p + 1))
+				s.replace(p, 3, "a");
+			keep(s); },
+		[&] { char s[c_size]; memcpy(s, raw_text, sizeof(s)); raw_replace(s, sizeof(s), "the", "a"); keep(s); });
+
+	run("replace(grow)", cap,
+		[&] { FS s(fs_text); s.replace("the", "THE!"); keep(s); },
+		[&] {
+			std::string s(text);
+			for (auto p = s.find("the"); p != std::string::npos; p = s.find("the", p + 4))
+				s.replace(p, 3, "THE!");
+			keep(s); },
+		[&] { char s[c_size]; memcpy(s, raw_text, sizeof(s)); raw_replace(s, sizeof(s), "the", "THE!"); keep(s); });
+
+	run("substring", cap,
+		[&] { keep(fs_text.substring(4, cap / 2)); },
+		[&] { keep(text.substr(4, cap / 2 - 4)); },
+		[&] { char s[c_size]; const auto n = cap / 2 - 4; memcpy(s, raw_text + 4, n); s[n] = 0; keep(s); });
+
+	//Sum of the field lengths, the old way via substring() copies then via views
+	run("fields(substring)", cap,
+		[&] {
+			unsigned long n = 0;
+			for (int pos = 0, next; pos <= static_cast<int>(fs_text.length()); pos = next + 1)
+			{
+				next = fs_text.indexOf(' ', static_cast<unsigned int>(pos));
+				if (next < 0)
+					next = static_cast<int>(fs_text.length());
+				const FS field = fs_text.substring(static_cast<unsigned int>(pos), static_cast<unsigned int>(next));
+				n += field.length();
+			}
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			for (size_t pos = 0, next; pos <= text.size(); pos = next + 1)
+			{
+				next = text.find(' ', pos);
+				if (next == std::string::npos)
+					next = text.size();
+				n += text.substr(pos, next - pos).size();
+			}
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			for (const char* p = raw_text;; p++)
+			{
+				const char* next = strchr(p, ' ');
+				if (next == nullptr)
+				{
+					n += strlen(p);
+					break;
+				}
+				n += static_cast<unsigned long>(next - p);
+				p = next;
+			}
+			keep_value(n); });
+
+	run("split", cap,
+		[&] { unsigned long n = 0; for (FixedStringView f : fs_text.split(' ')) n += f.length(); keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			const std::string_view sv(text);
+			for (size_t pos = 0, next; pos <= sv.size(); pos = next + 1)
+			{
+				next = sv.find(' ', pos);
+				if (next == std::string_view::npos)
+					next = sv.size();
+				n += sv.substr(pos, next - pos).size();
+			}
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			for (const char* p = raw_text;; p++)
+			{
+				const char* next = strchr(p, ' ');
+				if (next == nullptr)
+				{
+					n += strlen(p);
+					break;
+				}
+				n += static_cast<unsigned long>(next - p);
+				p = next;
+			}
+			keep_value(n); });
+
+	run("tokenize", cap,
+		[&] { unsigned long n = 0; for (FixedStringView t : fs_text.tokenize(" ,;")) n += t.length(); keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			const std::string_view sv(text);
+			for (size_t pos = sv.find_first_not_of(" ,;"); pos != std::string_view::npos; )
+			{
+				const auto next = sv.find_first_of(" ,;", pos);
+				n += (next == std::string_view::npos ? sv.size() : next) - pos;
+				pos = next == std::string_view::npos ? next : sv.find_first_not_of(" ,;", next);
+			}
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			char s[c_size];
+			memcpy(s, raw_text, sizeof(s));
+			char* save = nullptr;
+			for (char* t = strtok_r(s, " ,;", &save); t != nullptr; t = strtok_r(nullptr, " ,;", &save))
+				n += strlen(t);
+			keep_value(n); });
+
+	const FS fs_other(fs_text);
+	const std::string std_other(text);
+	char raw_other[c_size];
+	memcpy(raw_other, raw_text, sizeof(raw_other));
+	run("equals", cap,
+		[&] { keep_value(fs_text == fs_other); },
+		[&] { keep_value(text == std_other); },
+		[&] { keep_value(strcmp(raw_text, raw_other) == 0); });
+
+	//Pre-measured text: no strlen() of the rhs
+	const FixedStringView other_view(raw_other, static_cast<unsigned int>(strlen(raw_other)));
+	const std::string_view other_sv(raw_other);
+	run("equals(view)", cap,
+		[&] { keep_value(fs_text == other_view); },
+		[&] { keep_value(text == other_sv); },
+		[&] { keep_value(strcmp(raw_text, raw_other) == 0); });
+
+	run("equals(const char*)", cap,
+		[&] { keep_value(fs_text == raw_other); },
+		[&] { keep_value(text == raw_other); },
+		[&] { keep_value(strcmp(raw_text, raw_other) == 0); });
+
+	run("compareTo", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.compareTo(fs_other))); },
+		[&] { keep_value(static_cast<unsigned long>(text.compare(std_other))); },
+		[&] { keep_value(static_cast<unsigned long>(strcmp(raw_text, raw_other))); });
+
+	FS fs_upper(fs_text);
+	fs_upper.toUpperCase();
+	const std::string std_upper(fs_upper.c_str());
+	char raw_upper[c_size];
+	memcpy(raw_upper, fs_upper.c_str(), fs_upper.length() + 1);
+	const auto fold_equal = [](char a, char b) { return tolower(static_cast<unsigned char>(a)) == tolower(static_cast<unsigned char>(b)); };
+	run("equalsIgnoreCase", cap,
+		[&] { keep_value(fs_text.equalsIgnoreCase(fs_upper)); },
+		[&] { keep_value(text.size() == std_upper.size() && std::equal(text.begin(), text.end(), std_upper.begin(), fold_equal)); },
+		[&] { keep_value(strcasecmp(raw_text, raw_upper) == 0); });
+
+	run("compareToIgnoreCase", cap,
+		[&] { keep_value(static_cast<unsigned long>(fs_text.compareToIgnoreCase(fs_upper))); },
+		[&] { keep_value(static_cast<unsigned long>(std::lexicographical_compare(text.begin(), text.end(), std_upper.begin(), std_upper.end(),
+			[](char a, char b) { return tolower(static_cast<unsigned char>(a)) < tolower(static_cast<unsigned char>(b)); }))); },
+		[&] { keep_value(static_cast<unsigned long>(strcasecmp(raw_text, raw_upper))); });
+
+	run("toLowerCase", cap,
+		[&] { FS s(fs_upper); s.toLowerCase(); keep(s); },
+		[&] {
+			std::string s(std_upper);
+			std::transform(s.begin(), s.end(), s.begin(), [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+			keep(s); },
+		[&] {
+			char s[c_size];
+			memcpy(s, raw_upper, sizeof(s));
+			for (char* p = s; *p != '\0'; p++)
+				*p = static_cast<char>(tolower(static_cast<unsigned char>(*p)));
+			keep(s); });
+
+	//Header value style padding both ends
+	FS fs_padded("  ");
+	fs_padded += fs_text.view(0, cap > 4 ? cap - 4 : 0);
+	fs_padded += " \t";
+	const std::string std_padded(fs_padded.c_str());
+	run("trim", cap,
+		[&] { FS s(fs_padded); s.trim(); keep(s); },
+		[&] {
+			std::string s(std_padded);
+			s.erase(s.find_last_not_of(" \t\n\v\f\r") + 1);
+			s.erase(0, s.find_first_not_of(" \t\n\v\f\r"));
+			keep(s); },
+		[&] {
+			char s[c_size];
+			memcpy(s, fs_padded.c_str(), fs_padded.length() + 1);
+			char* start = s;
+			while (isspace(static_cast<unsigned char>(*start)))
+				start++;
+			size_t len = strlen(start);
+			while (len > 0 && isspace(static_cast<unsigned char>(start[len - 1])))
+				len--;
+			memmove(s, start, len);
+			s[len] = '\0';
+			keep(s); });
+
+	run("hash", cap,
+		[&] { keep_value(fs_text.hash()); },
+		[&] { keep_value(std::hash<std::string>()(text)); },
+		[&] { keep_value(std::hash<std::string_view>()(std::string_view(raw_text, strlen(raw_text)))); });
+
+	unsigned long num = 1234567u;
+	run("assign(long)", cap,
+		[&] { FS s; s.assign(static_cast<long>(++num)); keep(s); },
+		[&] { keep(std::to_string(static_cast<long>(++num))); },
+		[&] { char s[c_size]; snprintf(s, sizeof(s), "%ld", static_cast<long>(++num)); keep(s); });
+
+	run("assign(hex)", cap,
+		[&] { FS s; s.assign(++num, base16); keep(s); },
+		[&] { char b[32]; auto r = std::to_chars(b, b + sizeof(b), ++num, 16); keep(std::string(b, r.ptr)); },
+		[&] { char s[c_size]; snprintf(s, sizeof(s), "%lx", ++num); keep(s); });
+
+	double d = 3.14159;
+	run("assign(double)", cap,
+		[&] { FS s; s.assign(d += 0.25, 2); keep(s); },
+		[&] { char b[32]; snprintf(b, sizeof(b), "%4.2f", d += 0.25); keep(std::string(b)); },
+		[&] { char s[c_size]; snprintf(s, sizeof(s), "%4.2f", d += 0.25); keep(s); });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// Symbol lookup: FixedStringMap vs std::unordered_map vs a sorted char[] table
+///////////////////////////////////////////////////////////////////////////////////////////
+void bench_map()
+{
+	constexpr unsigned int c_cnt = 512;
+	static FixedStringMap<16, unsigned int, 1024> fixed;
+	std::unordered_map<std::string, unsigned int> std_map;
+	static char raw[c_cnt][16];
+	std::vector<std::string> keys;
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		char key[16];
+		snprintf(key, sizeof(key), "SYM%05u.X", i * 7919u % 100000u);
+		keys.push_back(key);
+		fixed.insert(key, i);
+		std_map[key] = i;
+	}
+	std::vector<std::string> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+	for (unsigned int i = 0; i < c_cnt; i++)
+		strcpy(raw[i], sorted[i].c_str());
+	unsigned int next = 0;
+	run("map find(const char*)", c_cnt,
+		[&] { keep_value(*fixed.find(keys[next++ % c_cnt].c_str())); },
+		[&] { keep_value(std_map.find(keys[next++ % c_cnt])->second); },
+		[&] {
+			const char* key = keys[next++ % c_cnt].c_str();
+			keep_value(reinterpret_cast<uintptr_t>(bsearch(key, raw, c_cnt, sizeof(raw[0]),
+				[](const void* a, const void* b) { return strcmp(static_cast<const char*>(a), static_cast<const char*>(b)); }))); });
+}
+
+void bench_pool()
+{
+	constexpr unsigned int c_cnt = 512;
+	static FixedStringPool<16, 1024> fixed;
+	std::unordered_map<std::string, unsigned int> std_map;
+	static char raw[c_cnt][16];
+	std::vector<std::string> keys;
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		char key[16];
+		snprintf(key, sizeof(key), "SYM%05u.X", i * 7919u % 100000u);
+		keys.push_back(key);
+		std_map.emplace(key, static_cast<unsigned int>(std_map.size()));
+	}
+	std::vector<std::string> sorted(keys);
+	std::sort(sorted.begin(), sorted.end());
+	for (unsigned int i = 0; i < c_cnt; i++)
+		strcpy(raw[i], sorted[i].c_str());
+	unsigned int next = 0;
+	run("pool intern", c_cnt,
+		[&] { keep_value(fixed.intern(keys[next++ % c_cnt].c_str())); },
+		[&] {
+			const auto& key = keys[next++ % c_cnt];
+			const auto it = std_map.find(key);
+			keep_value(it != std_map.end() ? it->second : std_map.emplace(key, static_cast<unsigned int>(std_map.size())).first->second); },
+		[&] {
+			const char* key = keys[next++ % c_cnt].c_str();
+			keep_value(reinterpret_cast<uintptr_t>(bsearch(key, raw, c_cnt, sizeof(raw[0]),
+				[](const void* a, const void* b) { return strcmp(static_cast<const char*>(a), static_cast<const char*>(b)); }))); });
+}
+
+//Copies then sorts the same unsorted symbols each iteration
+void bench_sort()
+{
+	constexpr unsigned int c_cnt = 4096;
+	std::vector<FixedString<16> > fixed_src;
+	std::vector<std::string> std_src;
+	static char raw_src[c_cnt][16];
+	static char raw[c_cnt][16];
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		char sym[16];
+		snprintf(sym, sizeof(sym), "%c%c%c%u.%c", 'A' + i * 7 % 26, 'A' + i * 13 % 23, 'A' + i % 19, i * 7919u % 1000u, 'A' + i % 4);
+		fixed_src.push_back(sym);
+		std_src.push_back(sym);
+		strcpy(raw_src[i], sym);
+	}
+	std::vector<FixedString<16> > fixed;
+	std::vector<std::string> std_vec;
+	run("sort", c_cnt,
+		[&] { fixed = fixed_src; FixedStringSort::sort(fixed.data(), fixed.data() + fixed.size()); keep(fixed[0]); },
+		[&] { std_vec = std_src; std::sort(std_vec.begin(), std_vec.end()); keep(std_vec[0]); },
+		[&] {
+			memcpy(raw, raw_src, sizeof(raw));
+			qsort(raw, c_cnt, sizeof(raw[0]), [](const void* a, const void* b) { return strcmp(static_cast<const char*>(a), static_cast<const char*>(b)); });
+			keep(raw[0]); });
+}
+
+//Reads every line of a ~64KB file per iteration
+void bench_reader()
+{
+	constexpr unsigned int c_lines = 1500;
+	char path[] = "/tmp/FixedStringBenchXXXXXX";
+	const int fd = mkstemp(path);
+	if (fd < 0)
+		return;
+	FILE* f = fdopen(fd, "w");
+	for (unsigned int i = 0; i < c_lines; i++)
+		fprintf(f, "%08u,SYM%05u.X,%u.%02u,%u\n", i, i * 7919u % 100000u, i % 500u, i % 100u, i * 31u % 10000u);
+	fclose(f);
+	run("read lines", 64,
+		[&] {
+			FixedStringReader<> in(path);
+			FixedString<64> line;
+			unsigned long n = 0;
+			while (in.next(line))
+				n += line.length();
+			keep_value(n); },
+		[&] {
+			std::ifstream in(path);
+			std::string line;
+			unsigned long n = 0;
+			while (std::getline(in, line))
+				n += line.size();
+			keep_value(n); },
+		[&] {
+			FILE* in = fopen(path, "r");
+			char line[64];
+			unsigned long n = 0;
+			while (fgets(line, sizeof(line), in) != nullptr)
+				n += strlen(line);
+			fclose(in);
+			keep_value(n); });
+	remove(path);
+}
+
+//Containers of large strings holding short text: growth and std::sort move only the used bytes
+void bench_copy()
+{
+	constexpr unsigned int c_cnt = 256;//Cache resident, larger is dominated by page faults
+	using FS = FixedString<256>;
+	struct Raw { char s[256]; };
+	std::vector<FS> fixed_src;
+	std::vector<std::string> std_src;
+	std::vector<Raw> raw_src;
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		Raw sym;
+		snprintf(sym.s, sizeof(sym.s), "%c%c%c%u.%c", 'A' + i * 7 % 26, 'A' + i * 13 % 23, 'A' + i % 19, i * 7919u % 1000u, 'A' + i % 4);
+		fixed_src.push_back(sym.s);
+		std_src.push_back(sym.s);
+		raw_src.push_back(sym);
+	}
+	run("vector growth", FS::capacity(),
+		[&] { std::vector<FS> v; for (const auto& s : fixed_src) v.push_back(s); keep(v[0]); },
+		[&] { std::vector<std::string> v; for (const auto& s : std_src) v.push_back(s); keep(v[0]); },
+		[&] { std::vector<Raw> v; for (const auto& s : raw_src) v.push_back(s); keep(v[0]); });
+	std::vector<FS> fixed;
+	std::vector<std::string> std_vec;
+	std::vector<Raw> raw;
+	run("std::sort", FS::capacity(),
+		[&] { fixed = fixed_src; std::sort(fixed.begin(), fixed.end()); keep(fixed[0]); },
+		[&] { std_vec = std_src; std::sort(std_vec.begin(), std_vec.end()); keep(std_vec[0]); },
+		[&] {
+			raw = raw_src;
+			std::sort(raw.begin(), raw.end(), [](const Raw& a, const Raw& b) { return strcmp(a.s, b.s) < 0; });
+			keep(raw[0]); });
+}
+
+//Composite key from a chain of + (one copy pass for FixedString)
+void bench_concat_key()
+{
+	const FixedString<32> fixed_venue("XNAS"), fixed_symbol("AAPL"), fixed_side("BUY");
+	const std::string std_venue("XNAS"), std_symbol("AAPL"), std_side("BUY");
+	unsigned long seq = 0;
+	run("a + b + c key", 62,
+		[&] { const FixedString<64> key = fixed_venue + ':' + fixed_symbol + '.' + fixed_side + "/day"; keep(key); },
+		[&] { const std::string key = std_venue + ':' + std_symbol + '.' + std_side + "/day"; keep(key); },
+		[&] {
+			char key[64];
+			snprintf(key, sizeof(key), "%s:%s.%s/day", fixed_venue.c_str(), fixed_symbol.c_str(), fixed_side.c_str());
+			keep(key);
+			keep_value(++seq); });
+}
+
+//A request's header values: mostly short, 1 in 16 long. FixedStringHybrid<32> spills the long
+//ones to an arena reset per request, the char[] are sized for the longest
+void bench_hybrid()
+{
+	constexpr unsigned int c_cnt = 64;
+	std::vector<std::string> values;
+	for (unsigned int i = 0; i < c_cnt; i++)
+		values.push_back(i % 16 == 5 ? std::string(200, static_cast<char>('a' + i % 26)) : "value-" + std::to_string(i * 7919u));
+	FixedStringArenaBuffer<8192> arena;
+	std::vector<FixedStringHybrid<32> > fixed(c_cnt, FixedStringHybrid<32>(&arena));
+	std::vector<std::string> std_vec(c_cnt);
+	struct Raw { char s[256]; };
+	std::vector<Raw> raw(c_cnt);
+	run("hybrid spill", 31,
+		[&] {
+			for (unsigned int i = 0; i < c_cnt; i++)
+				fixed[i].assign(values[i].data(), static_cast<unsigned int>(values[i].size()));
+			keep_value(fixed[5].length());
+			for (auto& s : fixed)
+				s.clear();
+			arena.reset(); },
+		[&] {
+			for (unsigned int i = 0; i < c_cnt; i++)
+				std_vec[i].assign(values[i]);
+			keep_value(std_vec[5].length());
+			for (auto& s : std_vec)
+				std::string().swap(s); },
+		[&] {
+			for (unsigned int i = 0; i < c_cnt; i++)
+				memcpy(raw[i].s, values[i].c_str(), values[i].size() + 1);
+			keep(raw); });
+}
+
+//Log records formatted on the hot thread, written by a consumer in batches of 256 to
+///dev/null: the FixedStringQueue vs a mutex protected std::deque<std::string> (a write() per
+//record) vs formatting into a char[] and writing it straight away
+void bench_log_queue()
+{
+	static FixedStringQueue<256, 1024> queue;
+	std::deque<std::string> deque;
+	std::mutex lock;
+	const int fd = open("/dev/null", O_WRONLY);
+	unsigned long seq = 0;
+	run("log queue", 256,
+		[&] {
+			queue.fmt("{} order {} filled {} @ {:.2}", "XNAS", ++seq, 100, 101.25);
+			if ((seq & 255) == 0)
+				while (queue.write_to(fd) > 0) {} },
+		[&] {
+			char text[256];
+			snprintf(text, sizeof(text), "%s order %lu filled %d @ %.2f\n", "XNAS", ++seq, 100, 101.25);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				deque.emplace_back(text);
+			}
+			if ((seq & 255) == 0)
+			{
+				std::deque<std::string> batch;
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					batch.swap(deque);
+				}
+				for (const auto& line : batch)
+					keep_value(static_cast<unsigned long>(write(fd, line.data(), line.size())));
+			} },
+		[&] {
+			char text[256];
+			const int len = snprintf(text, sizeof(text), "%s order %lu filled %d @ %.2f\n", "XNAS", ++seq, 100, 101.25);
+			keep_value(static_cast<unsigned long>(write(fd, text, static_cast<size_t>(len)))); });
+	if (enabled("log latency"))
+	{
+		//Producer side latency of each record with a consumer thread draining
+		constexpr unsigned int c_cnt = 100000;
+		std::vector<double> fixed_ns(c_cnt), std_ns(c_cnt);
+		std::atomic<bool> done(false);
+		std::thread consumer([&] {
+			while (!done.load(std::memory_order_relaxed))
+			{
+				while (queue.write_to(fd) > 0) {}
+				std::deque<std::string> batch;
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					batch.swap(deque);
+				}
+				for (const auto& line : batch)
+					keep_value(static_cast<unsigned long>(write(fd, line.data(), line.size())));
+				std::this_thread::yield();
+			} });
+		using clock = std::chrono::steady_clock;
+		for (unsigned int i = 0; i < c_cnt; i++)
+		{
+			const auto t0 = clock::now();
+			while (!queue.fmt("{} order {} filled {} @ {:.2}", "XNAS", i, 100, 101.25))
+				std::this_thread::yield();
+			const auto t1 = clock::now();
+			char text[256];
+			snprintf(text, sizeof(text), "%s order %u filled %d @ %.2f\n", "XNAS", i, 100, 101.25);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				deque.emplace_back(text);
+			}
+			const auto t2 = clock::now();
+			fixed_ns[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+			std_ns[i] = std::chrono::duration<double, std::nano>(t2 - t1).count();
+		}
+		done = true;
+		consumer.join();
+		std::sort(fixed_ns.begin(), fixed_ns.end());
+		std::sort(std_ns.begin(), std_ns.end());
+		for (double pct : { 50.0, 99.0, 99.9 })
+		{
+			const auto at = static_cast<size_t>(pct / 100.0 * (c_cnt - 1));
+			printf("%-16s p%-4g %5s %12.2f %12.2f %12s %8.2fx\n", "log latency", pct, "", fixed_ns[at], std_ns[at], "", std_ns[at] / fixed_ns[at]);
+		}
+	}
+	close(fd);
+}
+
+//A content filter: does a clean message (so every keyword is searched for) hold any of 200
+//keywords? FixedStringMatcher is one pass, the others search for each keyword in turn
+void bench_matcher()
+{
+	constexpr unsigned int c_cnt = 200;
+	static FixedStringMatcher<> matcher;
+	std::vector<std::string> std_words;
+	unsigned int seed = 12345;
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		std::string word;
+		for (unsigned int len = 4 + i % 6; word.size() < len; )
+		{
+			seed = seed * 1103515245u + 12345u;
+			word += static_cast<char>('a' + (seed >> 16) % 26);
+		}
+		matcher.add(word.c_str());
+		std_words.push_back(word);
+	}
+	matcher.compile();
+	const std::string std_msg = make_text(256);
+	const FixedString<256> fixed_msg(std_msg.c_str());
+	run("match 200 words", 256,
+		[&] { keep_value(matcher.contains(fixed_msg)); },
+		[&] {
+			bool found = false;
+			for (const auto& word : std_words)
+				found |= std_msg.find(word) != std::string::npos;
+			keep_value(found); },
+		[&] {
+			bool found = false;
+			for (const auto& word : std_words)
+				found |= strstr(fixed_msg.c_str(), word.c_str()) != nullptr;
+			keep_value(found); });
+}
+
+//Snapshot of a symbol table: 4096 symbols packed as length + text records and read back. The
+//std::string and char[] versions write the same format (a 1 byte length, all are short)
+void bench_serialize()
+{
+	constexpr unsigned int c_cnt = 4096;
+	static FixedString<32> fixed[c_cnt];
+	static FixedString<32> fixed_in[c_cnt];
+	std::vector<std::string> std_vec(c_cnt), std_in(c_cnt);
+	static char raw[c_cnt][32];
+	static char raw_in[c_cnt][32];
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		char sym[32];
+		snprintf(sym, sizeof(sym), i % 3 == 0 ? "SYM%05u.X" : "%u.EXCHANGE.SYMBOL", i * 7919u % 100000u);
+		fixed[i] = sym;
+		std_vec[i] = sym;
+		strcpy(raw[i], sym);
+	}
+	static char buf[c_cnt * 32];
+	run("serialize", 32,
+		[&] {
+			FixedStringSerialWriter out(buf, sizeof(buf));
+			keep_value(out.write(fixed, c_cnt));
+			keep(buf); },
+		[&] {
+			std::string out;
+			for (const auto& s : std_vec)
+			{
+				out += static_cast<char>(s.size());
+				out += s;
+			}
+			keep_value(out.size()); },
+		[&] {
+			size_t pos = 0;
+			for (unsigned int i = 0; i < c_cnt; i++)
+			{
+				const size_t len = strlen(raw[i]);
+				buf[pos++] = static_cast<char>(len);
+				memcpy(buf + pos, raw[i], len);
+				pos += len;
+			}
+			keep(buf); });
+	FixedStringSerialWriter out(buf, sizeof(buf));
+	const size_t size = out.write(fixed, c_cnt) == c_cnt ? out.size() : 0;
+	run("deserialize", 32,
+		[&] {
+			FixedStringSerialReader in(buf, size);
+			keep_value(in.read(fixed_in, c_cnt));
+			keep(fixed_in); },
+		[&] {
+			size_t pos = 0;
+			for (auto& s : std_in)
+			{
+				const size_t len = static_cast<unsigned char>(buf[pos]);
+				s.assign(buf + pos + 1, len);
+				pos += 1 + len;
+			}
+			keep_value(std_in[5].size()); },
+		[&] {
+			size_t pos = 0;
+			for (unsigned int i = 0; i < c_cnt; i++)
+			{
+				const size_t len = static_cast<unsigned char>(buf[pos]);
+				if (len >= sizeof(raw_in[i]))
+					break;
+				memcpy(raw_in[i], buf + pos + 1, len);
+				raw_in[i][len] = '\0';
+				pos += 1 + len;
+			}
+			keep(raw_in); });
+	//Straight to /dev/null: gathered from the strings with writev() vs packed into a buffer and written
+	const int fd = open("/dev/null", O_WRONLY);
+	static FixedStringSerialGather<c_cnt> gather;
+	run("serialize writev", 32,
+		[&] {
+			gather.add(fixed, c_cnt);
+			keep_value(static_cast<unsigned long>(gather.write_to(fd))); },
+		[&] {
+			std::string out;
+			for (const auto& s : std_vec)
+			{
+				out += static_cast<char>(s.size());
+				out += s;
+			}
+			keep_value(static_cast<unsigned long>(write(fd, out.data(), out.size()))); },
+		[&] {
+			size_t pos = 0;
+			for (unsigned int i = 0; i < c_cnt; i++)
+			{
+				const size_t len = strlen(raw[i]);
+				buf[pos++] = static_cast<char>(len);
+				memcpy(buf + pos, raw[i], len);
+				pos += len;
+			}
+			keep_value(static_cast<unsigned long>(write(fd, buf, pos))); });
+	close(fd);
+}
+
+void bench_parse()
+{
+	const FixedString<64> fixed_num("1234567890");
+	const std::string std_num("1234567890");
+	run("parse long", 64,
+		[&] { long v = 0; fixed_num.parse(v); keep_value(static_cast<unsigned long>(v)); },
+		[&] { keep_value(static_cast<unsigned long>(std::stol(std_num))); },
+		[&] { keep_value(static_cast<unsigned long>(strtol(fixed_num.c_str(), nullptr, 10))); });
+	const FixedString<64> fixed_list("12,-345,6789,100000,7,88,123456789,2024,15,-1");
+	const std::string std_list(fixed_list.c_str());
+	long values[16];
+	run("parse_list", 64,
+		[&] { keep_value(fixed_list.parse_list(values, 16)); keep(values); },
+		[&] {
+			unsigned long n = 0;
+			for (size_t pos = 0, used = 0; pos < std_list.size() && n < 16; pos += used + 1)
+				values[n++] = std::stol(std_list.substr(pos), &used);
+			keep_value(n);
+			keep(values); },
+		[&] {
+			unsigned long n = 0;
+			for (const char* p = fixed_list.c_str(); *p != '\0' && n < 16; p += *p == ',')
+				values[n++] = strtol(p, const_cast<char**>(&p), 10);
+			keep_value(n);
+			keep(values); });
+}
+
+//One scan of a whole column of symbols per iteration
+void bench_array()
+{
+	constexpr unsigned int c_cnt = 16384;
+	static FixedStringArray<32, c_cnt> fixed;
+	static FixedStringArray<32, c_cnt>::Selection hits;
+	std::vector<std::string> std_col;
+	static char raw[c_cnt][32];
+	for (unsigned int i = 0; i < c_cnt; i++)
+	{
+		char sym[32];
+		snprintf(sym, sizeof(sym), i % 3 == 0 ? "SYM%05u.X" : "%u.EXCHANGE.SYMBOL", i * 7919u % 100000u);
+		fixed.push_back(sym);
+		std_col.push_back(sym);
+		strcpy(raw[i], sym);
+	}
+	run("array startsWith", 32,
+		[&] { fixed.startsWith("SYM1", hits); keep_value(hits.count()); },
+		[&] {
+			unsigned long n = 0;
+			for (const auto& s : std_col)
+				n += s.compare(0, 4, "SYM1") == 0;
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			for (unsigned int i = 0; i < c_cnt; i++)
+				n += strncmp(raw[i], "SYM1", 4) == 0;
+			keep_value(n); });
+	run("array equals", 32,
+		[&] { fixed.equals("12345.EXCHANGE.SYMBOL", hits); keep_value(hits.count()); },
+		[&] {
+			unsigned long n = 0;
+			for (const auto& s : std_col)
+				n += s == "12345.EXCHANGE.SYMBOL";
+			keep_value(n); },
+		[&] {
+			unsigned long n = 0;
+			for (unsigned int i = 0; i < c_cnt; i++)
+				n += strcmp(raw[i], "12345.EXCHANGE.SYMBOL") == 0;
+			keep_value(n); });
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		g_filter = argv[1];
+	header();
+	bench_capacity<16>();
+	bench_capacity<64>();
+	bench_capacity<256>();
+	bench_capacity<1024>();
+	bench_capacity<4096>();
+	bench_map();
+	bench_pool();
+	bench_sort();
+	bench_reader();
+	bench_hybrid();
+	bench_log_queue();
+	bench_matcher();
+	bench_serialize();
+	bench_parse();
+	bench_concat_key();
+	bench_copy();
+	bench_array();
+	return g_sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,370 @@
+// Fixed String - host tests
+// (c) Copyright 2022 Fatlab Software Pty Ltd.
+//
+// Checks the non-Arduino classes the basic_test sketch can not run, against the std
+// library where there is an equivalent.
+//
+// Build & run (from this folder):
+//		g++ -O2 -std=c++17 -I../.. FixedStringTest.cpp -o FixedStringTest
+//		./FixedStringTest
+//
+// Prints each failed test and exits with 1 if any failed.
+
+//Profile every FixedString in this program (see FixedStringProfile.h)
+#define FIXEDSTRING_PROFILE
+#include "FixedString.h"
+#include "FixedStringMap.h"
+#include "FixedStringPool.h"
+#include "FixedStringSort.h"
+#include "FixedStringReader.h"
+#include "FixedStringQueue.h"
+#include <string>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// Harness
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+	int g_fail_cnt = 0;
+
+	void test(bool ok, int test_no, const char* what = "")
+	{
+		if (!ok)
+		{
+			printf("Test No: %i - Failed %s\n", test_no, what);
+			g_fail_cnt++;
+		}
+	}
+	std::string read_all(int fd)
+	{
+		std::string out;
+		char buf[4096];
+		for (ssize_t got; (got = read(fd, buf, sizeof(buf))) > 0;)
+			out.append(buf, static_cast<size_t>(got));
+		return out;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringMap - random insert/find/erase against std::map. 16 slots for 20 keys keeps
+// the probe runs long so erase has entries to shift back.
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_map()
+{
+	FixedStringMap<8, int, 16> map;
+	std::map<std::string, int> ref;
+	std::mt19937 rng(1);
+	int bad = 0;
+	for (int i = 0; i < 200000; i++)
+	{
+		char key[8];
+		snprintf(key, sizeof(key), "k%u", static_cast<unsigned>(rng() % 20));
+		const unsigned op = rng() % 3;
+		if (op == 0)
+		{
+			const bool room = ref.count(key) != 0 || ref.size() < map.capacity();
+			const int* stored = map.insert(key, i);
+			bad += (stored != NULL) != room;
+			if (room)
+				ref[key] = i;
+		}
+		else if (op == 1)
+			bad += map.erase(key) != (ref.erase(key) != 0);
+		else
+		{
+			const int* found = map.find(key);
+			const auto it = ref.find(key);
+			bad += it == ref.end() ? found != NULL : found == NULL || *found != it->second;
+		}
+		//Every key left must still be reachable from its home slot after an erase shift
+		if (op == 1)
+		{
+			for (const auto& kv : ref)
+			{
+				const int* found = map.find(kv.first.c_str());
+				bad += found == NULL || *found != kv.second;
+			}
+		}
+	}
+	test(bad == 0 && map.size() == ref.size(), 1, "map matches std::map");
+	test(map.insert("too long key", 1) == NULL && map.find("") == NULL, 2, "map key too long");
+	unsigned cnt = 0;
+	map.for_each([&cnt](const FixedString<8>&, int&) { cnt++; });
+	map.clear();
+	test(cnt == ref.size() && map.empty() && map.find("k1") == NULL, 3, "map clear");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringPool - ids are handed out in order and stay put whichever shard holds them
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_pool()
+{
+	static FixedStringPool<16, 2048> pool;
+	char s[16];
+	bool in_order = true;
+	for (unsigned i = 0; i < 1000; i++)
+	{
+		snprintf(s, sizeof(s), "sym%u", i);
+		in_order = in_order && pool.intern(s) == i;
+	}
+	test(in_order && pool.size() == 1000, 10, "pool ids in order");
+	//Threads interning the same strings in other orders get the same ids, new ones are unique
+	std::vector<std::thread> threads;
+	std::atomic<int> bad{ 0 };
+	for (unsigned t = 0; t < 4; t++)
+	{
+		threads.emplace_back([t, &bad] {
+			char name[16];
+			for (unsigned i = 0; i < 1000; i++)
+			{
+				const unsigned n = (i * 7 + t * 250) % 1000;
+				snprintf(name, sizeof(name), "sym%u", n);
+				bad += pool.intern(name) != n;
+				snprintf(name, sizeof(name), "new%u", i);
+				const auto id = pool.intern(name);
+				bad += id < 1000 || pool[id] != name;
+			}
+		});
+	}
+	for (auto& th : threads)
+		th.join();
+	test(bad == 0 && pool.size() == 2000, 11, "pool ids stable across threads");
+	bool found = true;
+	for (unsigned i = 0; i < 1000; i++)
+	{
+		snprintf(s, sizeof(s), "new%u", i);
+		const auto id = pool.find(s);
+		found = found && id != pool.npos && id >= 1000 && pool.view(id) == s;
+	}
+	test(found && pool.find("sym999") == 999 && pool.find("none") == pool.npos, 12, "pool find");
+	test(pool.intern("0123456789abcdefg") == pool.npos && pool.compare(1, 1) == 0 && pool.compare(0, 1) < 0, 13, "pool too long & compare");
+	static FixedStringPool<16, 64, true, 4> nocase;
+	const auto id = nocase.intern("Aapl");
+	test(nocase.intern("AAPL") == id && nocase.find("aapl") == id && nocase[id] == "Aapl", 14, "pool ignore case");
+	test(nocase[nocase.npos].empty() && nocase.view(id + 1).empty() && nocase.compare(id, nocase.npos) > 0, 15, "pool id not handed out");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringSort - the same order as std::sort, on one thread and on all of them
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_sort()
+{
+	std::mt19937 rng(2);
+	const char alphabet[] = "AB\x80\xff ";
+	for (int round = 0; round < 2; round++)
+	{
+		//Few distinct bytes and shared prefixes give deep buckets and many equal strings
+		std::vector<FixedString<16> > strings(round == 0 ? 5000 : 200000);
+		for (auto& s : strings)
+		{
+			const unsigned len = rng() % 15;
+			for (unsigned i = 0; i < len; i++)
+				s += alphabet[rng() % 5];
+		}
+		std::vector<FixedString<16> > expected(strings);
+		std::sort(expected.begin(), expected.end());
+		FixedStringSort::sort(strings.data(), strings.data() + strings.size(), round == 0 ? 1 : 0);
+		test(strings == expected, 20 + round, round == 0 ? "sort" : "sort on all cores");
+	}
+	std::vector<FixedString<300> > wide(3000);
+	for (auto& s : wide)
+	{
+		s.assign(rng() % 280, 'x');
+		s += static_cast<char>('a' + rng() % 3);
+	}
+	std::vector<FixedString<300> > expected(wide);
+	std::sort(expected.begin(), expected.end());
+	FixedStringSort::sort(wide.data(), wide.data() + wide.size());
+	test(wide == expected, 22, "sort long keys");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringReader - CRLF, a last line with no '\n' and a line longer than the buffer
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_reader()
+{
+	char path[] = "/tmp/FixedStringTestXXXXXX";
+	const int fd = mkstemp(path);
+	const std::string overlong(100, 'x');
+	const std::string text = "one\r\ntwo\n\n" + overlong + "\nthree\r\nlast";
+	const bool written = fd >= 0 && write(fd, text.data(), text.size()) == static_cast<ssize_t>(text.size());
+	if (fd >= 0)
+		close(fd);
+	test(written, 30, "reader temp file");
+
+	FixedStringReader<64> in(path);
+	std::vector<std::string> lines;
+	for (FixedStringView line; in.next(line);)
+		lines.emplace_back(line.data(), line.length());
+	const std::vector<std::string> expected = { "one", "two", "", overlong.substr(0, 64), "three", "last" };
+	test(!in.mapped() && lines == expected && in.overlong() == 1, 31, "reader lines");
+
+	//Batches into FixedStrings, truncated to the capacity
+	FixedStringReader<64> batch(path);
+	FixedString<8, FixedStringOverrunSilent> strings[8];
+	const size_t n = batch.read(strings, 8);
+	test(n == 6 && strings[0] == "one" && strings[3] == "xxxxxx" && strings[4] == "three" && strings[5] == "last" && batch.read(strings, 8) == 0, 32, "reader batch");
+
+	//A line that fills the buffer but for its "\r\n" is whole, one cut after a '\r' is not
+	const std::string whole(63, 'c'), cut(63, 'y');
+	const std::string crlf = whole + "\r\nnext\n" + cut + "\rzz\nend";
+	const int fd2 = open(path, O_WRONLY | O_TRUNC);
+	const bool rewritten = fd2 >= 0 && write(fd2, crlf.data(), crlf.size()) == static_cast<ssize_t>(crlf.size());
+	if (fd2 >= 0)
+		close(fd2);
+	FixedStringReader<64> crlf_in(path);
+	lines.clear();
+	for (FixedStringView line; crlf_in.next(line);)
+		lines.emplace_back(line.data(), line.length());
+	const std::vector<std::string> crlf_expected = { whole, "next", cut, "end" };
+	test(rewritten && lines == crlf_expected && crlf_in.overlong() == 1, 33, "reader CRLF at the buffer size");
+	unlink(path);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringQueue - records arrive whole and in order over a pipe too small for one writev()
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_queue()
+{
+	static FixedStringQueue<256, 1024> queue;
+	int fds[2];
+	test(pipe(fds) == 0 && fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0 && fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, 40, "queue pipe");
+	std::string expected;
+	for (unsigned i = 0; i < queue.capacity(); i++)
+	{
+		FixedString<256> record;
+		record.fmt("{} ", i);
+		record.concat(200 - record.length(), static_cast<char>('a' + i % 26));
+		expected += record.c_str();
+		expected += '\n';
+		queue.push(record);
+	}
+	test(queue.size() == queue.capacity() && !queue.push("full") && queue.dropped() == 1, 41, "queue full");
+	std::string received;
+	bool partial = false;
+	for (int tries = 0; !queue.empty() && tries < 10000; tries++)
+	{
+		const ssize_t written = queue.write_to(fds[1]);
+		partial = partial || (written > 0 && written % 201 != 0);
+		received += read_all(fds[0]);
+	}
+	received += read_all(fds[0]);
+	test(partial && received == expected, 42, "queue order after partial writes");
+
+	//Changing the delimiter between calls, a part written record ends with the one it began with
+	std::vector<std::string> sent;
+	for (unsigned i = 0; i < queue.capacity(); i++)
+	{
+		FixedString<256> record;
+		record.fmt("{} ", i);
+		record.concat(200 - record.length(), static_cast<char>('a' + i % 26));
+		sent.emplace_back(record.c_str());
+		queue.push(record);
+	}
+	received.clear();
+	partial = false;
+	for (int tries = 0; !queue.empty() && tries < 10000; tries++)
+	{
+		const ssize_t written = queue.write_to(fds[1], tries % 2 == 0 ? '\n' : ';');
+		partial = partial || (written > 0 && written % 201 != 0);
+		received += read_all(fds[0]);
+	}
+	received += read_all(fds[0]);
+	std::vector<std::string> split(1);
+	for (char c : received)
+	{
+		if (c == '\n' || c == ';')
+			split.emplace_back();
+		else
+			split.back() += c;
+	}
+	split.pop_back();
+	test(partial && split == sent, 43, "queue delimiter change after a partial write");
+	close(fds[0]);
+	close(fds[1]);
+
+	//Several producers, each one's records stay in its own order
+	static FixedStringQueue<32, 256> shared;
+	std::vector<std::thread> producers;
+	for (unsigned t = 0; t < 4; t++)
+	{
+		producers.emplace_back([t] {
+			for (unsigned i = 0; i < 10000; i++)
+			{
+				while (!shared.fmt("{} {}", t, i))
+					std::this_thread::yield();
+			}
+		});
+	}
+	unsigned next[4] = {};
+	unsigned received_cnt = 0;
+	bool ordered = true;
+	while (received_cnt < 40000)
+	{
+		received_cnt += shared.drain([&](const FixedString<32>& rec) {
+			const unsigned t = static_cast<unsigned>(rec.toInt());
+			FixedString<32> expect;
+			ordered = ordered && t < 4 && expect.fmt("{} {}", t, next[t]++) && rec == expect;
+		});
+	}
+	for (auto& th : producers)
+		th.join();
+	test(ordered && shared.empty(), 44, "queue producers in order");
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+// FixedStringProfile - the report after sets and truncations, with and without a tag.
+// FixedString<44> is only used here so its line is not counting anything else.
+///////////////////////////////////////////////////////////////////////////////////////////
+void test_profile()
+{
+	FixedStringProfile::report_at_exit(false);
+	FixedStringProfile::reset();
+	FixedString<44, FixedStringOverrunSilent> s;
+	s = "12345";		//Bucket <8
+	s = "1234567890";	//<16
+	{
+		FIXEDSTRING_PROFILE_TAG("parse");
+		s = "123456789012345678901234567890";	//<32
+		s.assign(50, 'x');	//Truncated to the capacity, 42
+	}
+	FILE* out = tmpfile();
+	FixedStringProfile::report(out);
+	rewind(out);
+	std::string report;
+	char line[256];
+	while (fgets(line, sizeof(line), out) != NULL)
+		report += line;
+	fclose(out);
+	test(report.find("      44       42              4          1       42        -        -\n") != std::string::npos, 50, "profile sizes");
+	test(report.find("lengths <8:1 <16:1 <32:1 <64:1\n") != std::string::npos, 51, "profile histogram");
+	test(report.find("tag parse                         2          1       42\n") != std::string::npos, 52, "profile tag");
+	FixedStringProfile::reset();
+	FILE* empty = tmpfile();
+	FixedStringProfile::report(empty);
+	const long size = ftell(empty);
+	fclose(empty);
+	test(size > 0 && FixedStringProfile::stats<44>(42).sets == 0, 53, "profile reset");
+}
+
+int main()
+{
+	printf("Host testing of FixedString classes....\n");
+	test_map();
+	test_pool();
+	test_sort();
+	test_reader();
+	test_queue();
+	test_profile();
+	if (g_fail_cnt > 0)
+		return 1;
+	printf("All tests passed\n");
+	return 0;
+}